@@ -0,0 +1,146 @@
+﻿// Потоковая сумма и обход с шагом в страницу по большому Vector<float> на std::allocator,
+// AlignedAllocator<64> и HugePageAllocator. Печатает пропускную способность и промахи
+// dTLB (через perf_event_open; если счётчики недоступны - "n/a").
+// Аргумент - размер вектора в мегабайтах (по умолчанию 512).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+
+// Счётчик промахов dTLB при чтении для текущего потока
+class TlbMissCounter
+{
+  public:
+
+    TlbMissCounter()
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~TlbMissCounter()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void start()
+    {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    std::string stop()
+    {
+        if (fd_ < 0) {
+            return "n/a";
+        }
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long misses = 0;
+        if (read(fd_, &misses, sizeof(misses)) != sizeof(misses)) {
+            return "n/a";
+        }
+        return std::to_string(misses);
+    }
+
+  private:
+
+    int fd_;
+};
+
+
+
+// Сумма с 16 независимыми аккумуляторами, чтобы компилятор мог векторизовать цикл
+template<typename Container>
+float streamingSum(const Container& v)
+{
+    float lanes[16] = {};
+    std::size_t i = 0;
+    for (; i + 16 <= v.size(); i += 16) {
+        for (std::size_t lane = 0; lane < 16; ++lane) {
+            lanes[lane] += v[i + lane];
+        }
+    }
+    float sum = 0;
+    for (; i < v.size(); ++i) {
+        sum += v[i];
+    }
+    for (float lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+
+
+// Обход с шагом в 4 КБ: каждое чтение попадает на новую обычную страницу
+template<typename Container>
+float pageStrideSum(const Container& v)
+{
+    const std::size_t stride = 4096 / sizeof(float);
+    float sum = 0;
+    for (std::size_t offset = 0; offset < stride; offset += 16) {
+        for (std::size_t i = offset; i < v.size(); i += stride) {
+            sum += v[i];
+        }
+    }
+    return sum;
+}
+
+
+
+template<typename Allocator>
+void run(const char* name, std::size_t megabytes)
+{
+    std::size_t count = megabytes * 1024 * 1024 / sizeof(float);
+    Vector<float, Allocator> v;
+    v.assign(count, 1.0f);
+
+    TlbMissCounter counter;
+    for (auto pass : {&streamingSum<Vector<float, Allocator>>, &pageStrideSum<Vector<float, Allocator>>}) {
+        counter.start();
+        auto start = std::chrono::steady_clock::now();
+        float sum = pass(v);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        std::string misses = counter.stop();
+
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        std::cout << name << (pass == &streamingSum<Vector<float, Allocator>> ? " streaming:   " : " page stride: ")
+                  << megabytes / seconds / 1024 << " GB/s, dTLB misses " << misses
+                  << " (sum " << sum << ", data % 64 = " << reinterpret_cast<std::uintptr_t>(&v[0]) % 64 << ")\n";
+    }
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 512;
+
+    run<std::allocator<float>>("std::allocator   ", megabytes);
+    run<AlignedAllocator<float, 64>>("AlignedAllocator ", megabytes);
+    run<HugePageAllocator<float>>("HugePageAllocator", megabytes);
+    return 0;
+}
@@ -0,0 +1,53 @@
+﻿// Добавление n элементов std::uint32_t: цикл pushBack против append(data, n) целиком
+// и порциями по 4096 элементов. n от 1K до 100M (аргумент - максимум в миллионах).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include "vector.hpp"
+
+template<typename Fill>
+void run(const char* name, std::size_t count, Fill fill)
+{
+    auto start = std::chrono::steady_clock::now();
+    Vector<std::uint32_t> v;
+    fill(v);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << name << " n = " << count << ": " << ns / count << " ns/element (back " << v.back() << ")\n";
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t maxCount = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100) * 1000 * 1000;
+
+    Vector<std::uint32_t> source;
+    source.resize(maxCount);
+    for (std::size_t i = 0; i < maxCount; ++i) {
+        source[i] = static_cast<std::uint32_t>(i);
+    }
+    const std::uint32_t* data = &source[0];
+
+    for (std::size_t count = 1000; count <= maxCount; count *= 10) {
+        run("pushBack loop  ", count, [&](Vector<std::uint32_t>& v) {
+            for (std::size_t i = 0; i < count; ++i) {
+                v.pushBack(data[i]);
+            }
+        });
+        run("append(data, n)", count, [&](Vector<std::uint32_t>& v) {
+            v.append(data, count);
+        });
+        run("append by 4096 ", count, [&](Vector<std::uint32_t>& v) {
+            for (std::size_t i = 0; i < count; i += 4096) {
+                v.append(data + i, std::min<std::size_t>(4096, count - i));
+            }
+        });
+    }
+    return 0;
+}
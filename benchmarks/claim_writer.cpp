@@ -0,0 +1,121 @@
+﻿// Сбор результатов соединения (пары индексов) из нескольких потоков, когда общий размер
+// известен заранее: ClaimWriter (claim отрезка на пакет, запись без блокировок), буферы
+// потоков с последовательной склейкой через append и ConcurrentVector::pushBack по одному
+// элементу. Пакеты - от 1 до 64 пар; выводится время в миллисекундах.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "claim_writer.hpp"
+#include "concurrent_vector.hpp"
+#include "vector.hpp"
+
+struct Match
+{
+    std::uint32_t left;
+    std::uint32_t right;
+};
+
+volatile std::uint64_t sink;
+
+const std::size_t batchesPerThread = 1 << 18;
+
+
+
+// Размер пакета batch потока thread: от 1 до 64, одинаковый во всех вариантах
+std::size_t batchSize(unsigned thread, std::size_t batch)
+{
+    return 1 + ((batch * 2654435761u + thread) >> 7) % 64;
+}
+
+
+
+template<typename Function>
+void measure(const char* name, unsigned threads, Function work)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::cout << "    " << name << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+              << " ms\n";
+}
+
+
+
+void run(unsigned threads)
+{
+    std::size_t total = 0;
+    for (unsigned t = 0; t < threads; ++t) {
+        for (std::size_t b = 0; b < batchesPerThread; ++b) {
+            total += batchSize(t, b);
+        }
+    }
+    std::cout << threads << " threads, " << total << " matches\n";
+
+    {
+        Vector<Match> output;
+        ClaimWriter<Vector<Match>> writer(output, total);
+        measure("claim + publish     ", threads, [&](unsigned t) {
+            for (std::size_t b = 0; b < batchesPerThread; ++b) {
+                auto span = writer.claim(batchSize(t, b));
+                for (std::size_t i = 0; i < span.size; ++i) {
+                    span[i] = Match{t, static_cast<std::uint32_t>(b + i)};
+                }
+                writer.publish(span.size);
+            }
+        });
+        sink = writer.finalize();
+    }
+
+    {
+        Vector<Match> output;
+        output.reserve(total);
+        std::vector<Vector<Match>> buffers(threads);
+        auto start = std::chrono::steady_clock::now();
+        measure("thread buffers      ", threads, [&](unsigned t) {
+            for (std::size_t b = 0; b < batchesPerThread; ++b) {
+                for (std::size_t i = 0, size = batchSize(t, b); i < size; ++i) {
+                    buffers[t].pushBack(Match{t, static_cast<std::uint32_t>(b + i)});
+                }
+            }
+        });
+        for (auto& buffer : buffers) {
+            output.append(buffer.data(), buffer.size());
+        }
+        std::cout << "      + concatenation: "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+                  << " ms total\n";
+        sink = output.size();
+    }
+
+    {
+        ConcurrentVector<Match> output;
+        output.reserve(total);
+        measure("ConcurrentVector    ", threads, [&](unsigned t) {
+            for (std::size_t b = 0; b < batchesPerThread; ++b) {
+                for (std::size_t i = 0, size = batchSize(t, b); i < size; ++i) {
+                    output.pushBack(Match{t, static_cast<std::uint32_t>(b + i)});
+                }
+            }
+        });
+        sink = output.size();
+    }
+}
+
+
+
+int main()
+{
+    for (unsigned threads = 1; threads <= 8; threads *= 2) {
+        run(threads);
+    }
+}
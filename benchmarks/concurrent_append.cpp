@@ -0,0 +1,80 @@
+﻿// Добавление из 1..64 потоков: ConcurrentVector::pushBack против Vector::pushBack под
+// std::mutex. Каждый поток добавляет свою долю из общего числа элементов; выводится
+// пропускная способность в миллионах добавлений в секунду. Масштабирование зависит от числа
+// ядер: при потоках больше ядер обе схемы упираются в переключения контекста.
+//
+// Столбец fetch_add - нижняя граница: только занятие слота в заранее выделенном буфере, без
+// сегментов и без публикации через size(). На одном ядре: около 70 млн/с у fetch_add, около 29
+// у ConcurrentVector. Без границы size() ConcurrentVector давал около 45: compare_exchange
+// границы на каждое добавление - цена того, что size() и at() видят только созданные элементы.
+// Когда флаг готовности ставился на каждом добавлении, а не только на завершившихся вне
+// очереди, выходило около 20.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+#include "vector.hpp"
+
+volatile std::uint64_t sink;
+
+
+
+template<typename Function>
+double mops(std::size_t total, unsigned threads, Function append)
+{
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::size_t count = total / threads;
+            for (std::size_t i = 0; i < count; ++i) {
+                append(t * count + i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return total / elapsed.count() / 1e6;
+}
+
+
+
+int main()
+{
+    const std::size_t total = 1 << 23;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    std::cout << "threads  fetch_add  ConcurrentVector  mutex+Vector (Mops/s)\n";
+
+    for (unsigned threads = 1; threads <= 64; threads *= 2) {
+        std::vector<std::uint64_t> buffer(total);
+        std::atomic<std::size_t> next{0};
+        double claimOnly = mops(total, threads, [&](std::uint64_t value) {
+            buffer[next.fetch_add(1, std::memory_order_relaxed)] = value;
+        });
+        sink = buffer[total - 1];
+
+        ConcurrentVector<std::uint64_t> concurrent;
+        double lockFree = mops(total, threads, [&](std::uint64_t value) {
+            concurrent.pushBack(value);
+        });
+        sink = concurrent[concurrent.size() - 1];
+
+        Vector<std::uint64_t> locked;
+        std::mutex mutex;
+        double withMutex = mops(total, threads, [&](std::uint64_t value) {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.pushBack(value);
+        });
+        sink = locked[locked.size() - 1];
+
+        std::cout << "    " << threads << "\t" << claimOnly << "\t" << lockFree << "\t\t" << withMutex << "\n";
+    }
+}
@@ -0,0 +1,95 @@
+﻿// Поэлементная арифметика над Vector<double> из 3-5 операндов: ленивые выражения
+// (vector_expressions.hpp, один проход без временных векторов) против операций,
+// каждая из которых возвращает новый Vector. Размеры: в кэше и в основной памяти.
+
+#include <chrono>
+#include <iostream>
+
+#include "vector.hpp"
+#include "vector_expressions.hpp"
+
+volatile double sink;
+
+
+
+// Поэлементная операция с материализацией результата во временный вектор
+template<typename Operation>
+Vector<double> materialize(const Vector<double>& left, const Vector<double>& right, Operation operation)
+{
+    Vector<double> result;
+    double* out = result.growForOverwrite(left.size());
+    for (std::size_t i = 0; i < left.size(); ++i) {
+        out[i] = operation(left[i], right[i]);
+    }
+    return result;
+}
+
+auto plus = [](double x, double y) { return x + y; };
+auto minus = [](double x, double y) { return x - y; };
+auto multiplies = [](double x, double y) { return x * y; };
+
+
+
+template<typename Function>
+void measure(const char* name, std::size_t count, std::size_t repeats, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        sink = function();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "    " << name << ": " << seconds * 1e9 / static_cast<double>(count * repeats) << " ns/element\n";
+}
+
+
+
+void run(std::size_t count)
+{
+    Vector<double> a, b, c, d, e;
+    for (std::size_t i = 0; i < count; ++i) {
+        a.pushBack(static_cast<double>(i % 7));
+        b.pushBack(static_cast<double>(i % 11));
+        c.pushBack(static_cast<double>(i % 13));
+        d.pushBack(static_cast<double>(i % 17));
+        e.pushBack(static_cast<double>(i % 19));
+    }
+    const std::size_t repeats = std::max<std::size_t>(1, 200000000 / count);
+    Vector<double> r;
+
+    std::cout << count << " elements\n";
+
+    measure("a * b + c             temporaries", count, repeats, [&] {
+        r = materialize(materialize(a, b, multiplies), c, plus);
+        return r[0];
+    });
+    measure("a * b + c             expression ", count, repeats, [&] {
+        r = a * b + c;
+        return r[0];
+    });
+
+    measure("a * b + c * d         temporaries", count, repeats, [&] {
+        r = materialize(materialize(a, b, multiplies), materialize(c, d, multiplies), plus);
+        return r[0];
+    });
+    measure("a * b + c * d         expression ", count, repeats, [&] {
+        r = a * b + c * d;
+        return r[0];
+    });
+
+    measure("a * b + c * d - e     temporaries", count, repeats, [&] {
+        r = materialize(materialize(materialize(a, b, multiplies), materialize(c, d, multiplies), plus), e, minus);
+        return r[0];
+    });
+    measure("a * b + c * d - e     expression ", count, repeats, [&] {
+        r = a * b + c * d - e;
+        return r[0];
+    });
+}
+
+
+
+int main()
+{
+    run(4096);
+    run(4 * 1024 * 1024);
+}
@@ -0,0 +1,60 @@
+﻿// Заполнение Vector<std::uint64_t> через pushBack с разными политиками роста:
+// пропускная способность и пиковый RSS. Каждый замер - в отдельном процессе.
+// Аргумент - количество элементов в миллионах (по умолчанию 50).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+
+template<typename Allocator, typename GrowthPolicy>
+void fill(const char* name, std::size_t count)
+{
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid != 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Vector<std::uint64_t, Allocator, GrowthPolicy> v;
+    for (std::size_t i = 0; i < count; ++i) {
+        v.pushBack(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::cout << name << ": " << ns / count << " ns/element, capacity " << v.capacity()
+              << ", peak RSS " << usage.ru_maxrss / 1024 << " MB\n";
+    std::exit(0);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t count = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50) * 1000 * 1000;
+
+    using Std = std::allocator<std::uint64_t>;
+    using Malloc = MallocAllocator<std::uint64_t>;
+
+    fill<Std, DoublingGrowth>("std::allocator,  2x           ", count);
+    fill<Std, GoldenGrowth>("std::allocator,  1.5x         ", count);
+    fill<Std, SizeClassGrowth<>>("std::allocator,  size class   ", count);
+    fill<Std, PageGranularGrowth<>>("std::allocator,  page granular", count);
+    fill<Malloc, DoublingGrowth>("MallocAllocator, 2x           ", count);
+    fill<Malloc, GoldenGrowth>("MallocAllocator, 1.5x         ", count);
+    fill<Malloc, SizeClassGrowth<>>("MallocAllocator, size class   ", count);
+    fill<Malloc, PageGranularGrowth<>>("MallocAllocator, page granular", count);
+    return 0;
+}
@@ -0,0 +1,93 @@
+﻿// Задержка отдельных pushBack (p50, p99, p99.99, max): Vector, который при удвоении копирует
+// весь буфер в одном добавлении, против IncrementalVector, который переносит старые элементы
+// по MigrateStep за добавление, и StableVector, который не переносит их вовсе. Затем скорость
+// чтения по индексу: у IncrementalVector - во время переноса и после него.
+// Аргумент - число элементов std::uint64_t в миллионах (по умолчанию 32, то есть 256 МБ).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "incremental_vector.hpp"
+#include "stable_vector.hpp"
+#include "vector.hpp"
+
+volatile std::uint64_t sink;
+
+
+
+// Задержка каждого добавления в наносекундах, затем перцентили
+template<typename Container>
+void appendLatency(const char* name, std::size_t count)
+{
+    std::vector<std::uint32_t> latencies(count);
+    Container c;
+    auto begin = std::chrono::steady_clock::now();
+    auto previous = begin;
+    for (std::size_t i = 0; i < count; ++i) {
+        c.pushBack(i);
+        auto now = std::chrono::steady_clock::now();
+        latencies[i] = static_cast<std::uint32_t>(
+            std::min<std::int64_t>(UINT32_MAX, std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count()));
+        previous = now;
+    }
+    auto total = std::chrono::duration_cast<std::chrono::milliseconds>(previous - begin).count();
+    sink = c[count - 1];
+
+    auto percentile = [&](double p) {
+        auto nth = latencies.begin() + static_cast<std::ptrdiff_t>(p * (count - 1));
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    };
+    std::cout << "    " << name << ": total " << total << " ms, p50 " << percentile(0.5) << " ns, p99 "
+              << percentile(0.99) << " ns, p99.99 " << percentile(0.9999) << " ns, max "
+              << *std::max_element(latencies.begin(), latencies.end()) << " ns\n";
+}
+
+
+
+template<typename Container>
+void scan(const char* name, const Container& c)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        sum += c[i];
+    }
+    sink = sum;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "    " << name << ": " << c.size() * sizeof(std::uint64_t) / elapsed.count() / 1e9 << " GB/s\n";
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t count = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32) * 1000 * 1000;
+
+    std::cout << "append " << count << " elements\n";
+    appendLatency<Vector<std::uint64_t>>("Vector           ", count);
+    appendLatency<IncrementalVector<std::uint64_t>>("IncrementalVector", count);
+    appendLatency<StableVector<std::uint64_t>>("StableVector     ", count);
+
+    Vector<std::uint64_t> vector;
+    IncrementalVector<std::uint64_t> incremental;
+    for (std::size_t i = 0; i < count; ++i) {
+        vector.pushBack(i);
+        incremental.pushBack(i);
+    }
+
+    // Доводит IncrementalVector до роста: чтение идёт, пока почти все элементы в старом буфере
+    while (!incremental.migrating()) {
+        incremental.pushBack(incremental.size());
+    }
+
+    std::cout << "scan (sum by index)\n";
+    scan("Vector                       ", vector);
+    scan("IncrementalVector, migrating ", incremental);
+    incremental.finishMigration();
+    scan("IncrementalVector, migrated  ", incremental);
+}
@@ -0,0 +1,62 @@
+﻿// Поддержание отсортированного пакета: вставка случайных ключей в середину через
+// lower_bound + insert и удаление диапазонов erase(first, last). Сравниваются
+// тривиально переносимый ключ (сдвиг memmove) и ключ с пользовательским перемещением
+// (поэлементный сдвиг).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+#include "vector.hpp"
+
+struct MovableKey
+{
+    MovableKey(std::uint64_t value = 0) : value(value) {}
+    MovableKey(const MovableKey& other) : value(other.value) {}
+    MovableKey(MovableKey&& other) noexcept : value(other.value) {}
+    MovableKey& operator=(const MovableKey& other) { value = other.value; return *this; }
+    MovableKey& operator=(MovableKey&& other) noexcept { value = other.value; return *this; }
+
+    bool operator<(const MovableKey& other) const { return value < other.value; }
+
+    std::uint64_t value;
+};
+
+
+
+template<typename Key>
+void run(const char* name, std::size_t count)
+{
+    std::mt19937_64 random(42);
+
+    Vector<Key> v;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; ++i) {
+        Key key(random());
+        v.insert(static_cast<std::size_t>(std::lower_bound(v.begin(), v.end(), key) - v.begin()), key);
+    }
+    auto inserted = std::chrono::steady_clock::now();
+    while (v.size() > 64) {
+        std::size_t first = random() % (v.size() - 64);
+        v.erase(first, first + 64);
+    }
+    auto erased = std::chrono::steady_clock::now();
+
+    std::cout << name << ": " << count << " middle inserts "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(inserted - start).count() << " ms, "
+              << "bulk erase by 64 "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(erased - inserted).count() << " ms\n";
+}
+
+
+
+int main()
+{
+    for (std::size_t count : {10000, 100000}) {
+        run<std::uint64_t>("std::uint64_t (memmove)  ", count);
+        run<MovableKey>("MovableKey (element-wise)", count);
+    }
+    return 0;
+}
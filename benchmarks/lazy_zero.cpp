@@ -0,0 +1,56 @@
+﻿// Разреженный аккумулятор: resize большого Vector<double> нулями и запись в каждый
+// десятый блок по 4 КБ. std::allocator заполняет нулями весь буфер, MallocAllocator берёт
+// его у mmap и ядро выдаёт нулевые страницы лениво. Каждый вариант - в отдельном процессе.
+// Аргумент - размер вектора в мегабайтах (по умолчанию 2048).
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+
+template<typename Allocator>
+void accumulate(const char* name, std::size_t megabytes)
+{
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid != 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+
+    std::size_t count = megabytes * 1024 * 1024 / sizeof(double);
+    const std::size_t perPage = 4096 / sizeof(double);
+
+    auto start = std::chrono::steady_clock::now();
+    Vector<double, Allocator> v;
+    v.resize(count);
+    auto resized = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < count; i += 10 * perPage) {
+        v[i] += 1.0;
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << name << ": resize " << std::chrono::duration_cast<std::chrono::milliseconds>(resized - start).count()
+              << " ms, updates " << std::chrono::duration_cast<std::chrono::milliseconds>(finish - resized).count()
+              << " ms, peak RSS " << usage.ru_maxrss / 1024 << " MB\n";
+    std::exit(0);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2048;
+
+    accumulate<std::allocator<double>>("std::allocator ", megabytes);
+    accumulate<MallocAllocator<double>>("MallocAllocator", megabytes);
+    return 0;
+}
@@ -0,0 +1,51 @@
+﻿// Скорость последовательного чтения Vector, страницы которого привязаны NumaAllocator к
+// каждому узлу по очереди и чередуются между узлами, и время migrate на узел 0. На машине
+// с одним узлом все варианты совпадают; на многосокетной - удалённые узлы медленнее.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+#include "vector_kernels.hpp"
+
+volatile std::uint64_t sink;
+
+using Allocator = NumaAllocator<std::uint64_t>;
+
+
+
+void scan(const char* name, const NumaPolicy& policy)
+{
+    const std::size_t count = (std::size_t(256) << 20) / sizeof(std::uint64_t);
+    Vector<std::uint64_t, Allocator> v{Allocator(policy)};
+    v.assign(count, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < 10; ++r) {
+        sink = kernels::sum(v.data(), v.size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto migrateStart = std::chrono::steady_clock::now();
+    bool migrated = v.migrate(0);
+    auto migrateTime = std::chrono::steady_clock::now() - migrateStart;
+
+    std::cout << name << ": scan " << 10.0 * static_cast<double>(count * sizeof(std::uint64_t)) / seconds / 1e9
+              << " GB/s, page on node " << numa::nodeOf(v.data()) << ", migrate to node 0 "
+              << (migrated ? "" : "failed ")
+              << std::chrono::duration_cast<std::chrono::milliseconds>(migrateTime).count() << " ms\n";
+}
+
+
+
+int main()
+{
+    std::cout << numa::nodeCount() << " NUMA node(s)\n";
+    for (int node = 0; node < numa::nodeCount(); ++node) {
+        std::cout << "node " << node << "    ";
+        scan("bind", NumaPolicy::bind(node));
+    }
+    scan("interleave   ", NumaPolicy::interleave());
+}
@@ -0,0 +1,68 @@
+﻿// Копирующий конструктор, assign, resize и append для буфера в 1 ГБ последовательно и
+// в параллельном режиме (parallel::enable): каждый поток заполняет и первым касается
+// своей части нового буфера. Выигрыш зависит от числа ядер и каналов памяти; на
+// многосокетных машинах страницы копии распределяются по узлам потоков.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "parallel.hpp"
+#include "vector.hpp"
+
+volatile std::uint64_t sink;
+
+
+
+template<typename Function>
+void measure(const char* name, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::cout << "    " << name << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+              << " ms\n";
+}
+
+
+
+void run(const char* mode)
+{
+    const std::size_t count = (std::size_t(1) << 30) / sizeof(std::uint64_t);
+    std::cout << mode << ", " << parallel::threadsFor(count * sizeof(std::uint64_t)) << " threads\n";
+
+    Vector<std::uint64_t> source;
+    source.assign(count, 3);
+
+    measure("assign     ", [&] {
+        Vector<std::uint64_t> v;
+        v.assign(count, 0x0101010101010102);
+        sink = v[count - 1];
+    });
+    measure("resize     ", [&] {
+        Vector<std::uint64_t> v;
+        v.reserve(count);
+        v.resize(count);
+        sink = v[count - 1];
+    });
+    measure("copy       ", [&] {
+        Vector<std::uint64_t> v(source);
+        sink = v[count - 1];
+    });
+    measure("append     ", [&] {
+        Vector<std::uint64_t> v;
+        v.pushBack(1);
+        v.append(source.data(), source.size() - 1);
+        sink = v[count - 1];
+    });
+}
+
+
+
+int main()
+{
+    run("sequential");
+    parallel::enable(64 * 1024 * 1024);
+    run("parallel");
+}
@@ -0,0 +1,54 @@
+﻿// Удвоение большого Vector<std::uint64_t>: std::allocator (новый буфер + memcpy)
+// против MallocAllocator (mremap). Каждый вариант запускается в отдельном процессе,
+// чтобы пиковый RSS (ru_maxrss) относился только к нему.
+// Аргумент - размер вектора до удвоения в мегабайтах (по умолчанию 256).
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "allocators.hpp"
+#include "vector.hpp"
+
+template<typename Allocator>
+void grow(const char* name, std::size_t megabytes)
+{
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid != 0) {
+        waitpid(pid, nullptr, 0);
+        return;
+    }
+
+    std::size_t count = megabytes * 1024 * 1024 / sizeof(std::uint64_t);
+    Vector<std::uint64_t, Allocator> v;
+    v.reserve(count);
+    v.resize(count);
+
+    auto start = std::chrono::steady_clock::now();
+    v.reserve(count + 1);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << name << ": " << megabytes << " MB -> " << 2 * megabytes << " MB, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us, "
+              << "peak RSS " << usage.ru_maxrss / 1024 << " MB\n";
+    std::exit(0);
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+
+    grow<std::allocator<std::uint64_t>>("std::allocator ", megabytes);
+    grow<MallocAllocator<std::uint64_t>>("MallocAllocator", megabytes);
+    return 0;
+}
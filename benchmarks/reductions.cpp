@@ -0,0 +1,124 @@
+﻿// Свёртки арифметических Vector: наивный цикл по operator[], стандартный алгоритм и ядро
+// из vector_kernels.hpp. Для чисел с плавающей точкой компилятор не векторизует наивные
+// циклы без -ffast-math; целые циклы на -O3 он векторизует сам. Размеры подобраны так,
+// чтобы данные лежали в L2 и в основной памяти. Набор инструкций ядер выбирается по cpuid;
+// для сравнения путей его можно ограничить: VECTOR_KERNELS_ISA=sse4.2 ./BenchReductions
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+#include "vector.hpp"
+#include "vector_kernels.hpp"
+
+volatile std::size_t sink;
+
+
+
+template<typename Function>
+void measure(const char* name, std::size_t bytes, std::size_t repeats, Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        sink = static_cast<std::size_t>(function());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "    " << name << ": " << bytes * repeats / seconds / 1e9 << " GB/s\n";
+}
+
+
+
+template<typename Type>
+void run(const char* typeName, std::size_t count)
+{
+    Vector<Type> v;
+    for (std::size_t i = 0; i < count; ++i) {
+        v.pushBack(static_cast<Type>((i * 2654435761u) % 1000));
+    }
+    Vector<Type> out(v);
+    const std::size_t bytes = count * sizeof(Type);
+    const std::size_t repeats = std::max<std::size_t>(1, (std::size_t(1) << 31) / bytes);
+    const Type missing = static_cast<Type>(-1);
+
+    std::cout << typeName << ", " << bytes / 1024 << " KB\n";
+
+    measure("sum naive          ", bytes, repeats, [&] {
+        Type result = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            result += v[i];
+        }
+        return result;
+    });
+    measure("sum std::accumulate", bytes, repeats, [&] { return std::accumulate(v.begin(), v.end(), Type()); });
+    measure("sum kernels        ", bytes, repeats, [&] { return kernels::sum(v); });
+
+    measure("dot naive          ", 2 * bytes, repeats, [&] {
+        Type result = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            result += v[i] * out[i];
+        }
+        return result;
+    });
+    measure("dot kernels        ", 2 * bytes, repeats, [&] { return kernels::dot(v, out); });
+
+    measure("argmin naive       ", bytes, repeats, [&] {
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < v.size(); ++i) {
+            if (v[i] < v[best]) {
+                best = i;
+            }
+        }
+        return best;
+    });
+    measure("argmin min_element ", bytes, repeats, [&] { return std::min_element(v.begin(), v.end()) - v.begin(); });
+    measure("argmin kernels     ", bytes, repeats, [&] { return kernels::argmin(v); });
+
+    measure("count std::count   ", bytes, repeats, [&] { return std::count(v.begin(), v.end(), Type(7)); });
+    measure("count kernels      ", bytes, repeats, [&] { return kernels::count(v, Type(7)); });
+
+    measure("find std::find     ", bytes, repeats, [&] { return std::find(v.begin(), v.end(), missing) - v.begin(); });
+    measure("find kernels       ", bytes, repeats, [&] { return kernels::find(v, missing); });
+
+    measure("prefix partial_sum ", 2 * bytes, repeats, [&] {
+        std::partial_sum(v.begin(), v.end(), out.begin());
+        return out[0];
+    });
+    measure("prefix kernels     ", 2 * bytes, repeats, [&] {
+        kernels::prefixSum(v.data(), v.size(), out.data());
+        return out[0];
+    });
+
+    measure("fill std::fill_n   ", bytes, repeats, [&] {
+        std::fill_n(out.data(), out.size(), Type(3));
+        return out[0];
+    });
+    measure("fill kernels       ", bytes, repeats, [&] {
+        kernels::fill(out.data(), out.size(), Type(3));
+        return out[0];
+    });
+
+    measure("copy memcpy        ", 2 * bytes, repeats, [&] {
+        std::memcpy(out.data(), v.data(), bytes);
+        return out[0];
+    });
+    measure("copy kernels       ", 2 * bytes, repeats, [&] {
+        kernels::copy(v.data(), v.size(), out.data());
+        return out[0];
+    });
+}
+
+
+
+int main()
+{
+    std::cout << "Kernels: " << kernels::isaName(kernels::activeIsa()) << "\n";
+    for (std::size_t bytes : {std::size_t(256) * 1024, std::size_t(64) * 1024 * 1024}) {
+        run<float>("float", bytes / sizeof(float));
+        run<double>("double", bytes / sizeof(double));
+        run<std::int32_t>("int32_t", bytes / sizeof(std::int32_t));
+        run<std::int64_t>("int64_t", bytes / sizeof(std::int64_t));
+    }
+}
@@ -0,0 +1,77 @@
+﻿// Сравнение переаллокаций при заполнении Vector<std::string> через pushBack:
+// std::string перемещается без исключений и переносится move-конструктором,
+// а ThrowingMoveString (тот же std::string, но с "бросающим" перемещением)
+// по-прежнему копируется, как это делал reserve раньше.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include "vector.hpp"
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+struct ThrowingMoveString
+{
+    ThrowingMoveString(const std::string& value) : value(value) {}
+    ThrowingMoveString(const ThrowingMoveString&) = default;
+    ThrowingMoveString(ThrowingMoveString&& other) noexcept(false) : value(std::move(other.value)) {}
+
+    std::string value;
+};
+
+
+
+template<typename Type>
+void fill(const char* name, std::size_t count)
+{
+    const std::string payload(64, 'x');
+
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    {
+        Vector<Type> v;
+        for (std::size_t i = 0; i < count; ++i) {
+            v.pushBack(Type(payload));
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << count << " elements, "
+              << allocations << " allocations, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() << " us\n";
+}
+
+
+
+int main()
+{
+    for (std::size_t count : {1000u, 100000u, 1000000u}) {
+        fill<ThrowingMoveString>("copy relocation", count);
+        fill<std::string>("move relocation", count);
+    }
+    return 0;
+}
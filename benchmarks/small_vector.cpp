@@ -0,0 +1,69 @@
+﻿// Создание, заполнение pushBack и удаление коротких векторов (0-64 элемента):
+// Vector против SmallVector с N = 8 и N = 16. Печатает время и число выделений
+// памяти на один вектор.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "vector.hpp"
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if (void* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+
+template<typename Container>
+void run(const char* name, std::size_t count)
+{
+    const std::size_t repeats = 1000000;
+
+    allocations = 0;
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        Container v;
+        for (std::size_t i = 0; i < count; ++i) {
+            v.pushBack(static_cast<int>(i + r));
+        }
+        if (!v.empty()) {
+            checksum += v.back();
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / repeats;
+    std::cout << name << " size " << count << ": " << ns << " ns, "
+              << double(allocations) / repeats << " allocations (checksum " << checksum % 10 << ")\n";
+}
+
+
+
+int main()
+{
+    for (std::size_t count : {0, 1, 2, 4, 8, 16, 32, 64}) {
+        run<Vector<int>>("Vector          ", count);
+        run<SmallVector<int, 8>>("SmallVector<8>  ", count);
+        run<SmallVector<int, 16>>("SmallVector<16> ", count);
+    }
+    return 0;
+}
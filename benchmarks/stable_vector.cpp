@@ -0,0 +1,106 @@
+﻿// Задержка отдельных pushBack и скорость чтения: Vector против StableVector.
+// Vector при удвоении копирует весь буфер - редкие, но очень долгие добавления;
+// StableVector выделяет один блок, и хвост распределения задержек остаётся коротким.
+// Аргумент - число элементов std::uint64_t в миллионах (по умолчанию 32, то есть 256 МБ).
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "stable_vector.hpp"
+#include "vector.hpp"
+
+volatile std::uint64_t sink;
+
+
+
+// Задержка каждого добавления в наносекундах, затем перцентили
+template<typename Container>
+void appendLatency(const char* name, std::size_t count)
+{
+    std::vector<std::uint32_t> latencies(count);
+    Container c;
+    auto begin = std::chrono::steady_clock::now();
+    auto previous = begin;
+    for (std::size_t i = 0; i < count; ++i) {
+        c.pushBack(i);
+        auto now = std::chrono::steady_clock::now();
+        latencies[i] = static_cast<std::uint32_t>(
+            std::min<std::int64_t>(UINT32_MAX, std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count()));
+        previous = now;
+    }
+    auto total = std::chrono::duration_cast<std::chrono::milliseconds>(previous - begin).count();
+    sink = c[count - 1];
+
+    auto percentile = [&](double p) {
+        auto nth = latencies.begin() + static_cast<std::ptrdiff_t>(p * (count - 1));
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    };
+    std::cout << "    " << name << ": total " << total << " ms, p50 " << percentile(0.5) << " ns, p99 "
+              << percentile(0.99) << " ns, p99.99 " << percentile(0.9999) << " ns, max "
+              << *std::max_element(latencies.begin(), latencies.end()) << " ns\n";
+}
+
+
+
+template<typename Function>
+void scan(const char* name, std::size_t count, Function sum)
+{
+    auto start = std::chrono::steady_clock::now();
+    sink = sum();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "    " << name << ": " << count * sizeof(std::uint64_t) / elapsed.count() / 1e9 << " GB/s\n";
+}
+
+
+
+int main(int argc, char** argv)
+{
+    std::size_t count = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32) * 1000 * 1000;
+
+    std::cout << "append " << count << " elements\n";
+    appendLatency<Vector<std::uint64_t>>("Vector      ", count);
+    appendLatency<StableVector<std::uint64_t>>("StableVector", count);
+
+    Vector<std::uint64_t> vector;
+    StableVector<std::uint64_t> stable;
+    for (std::size_t i = 0; i < count; ++i) {
+        vector.pushBack(i);
+        stable.pushBack(i);
+    }
+
+    std::cout << "scan (sum)\n";
+    scan("Vector, index             ", count, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < vector.size(); ++i) {
+            sum += vector[i];
+        }
+        return sum;
+    });
+    scan("StableVector, index       ", count, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < stable.size(); ++i) {
+            sum += stable[i];
+        }
+        return sum;
+    });
+    scan("StableVector, iterators   ", count, [&] {
+        return std::accumulate(stable.begin(), stable.end(), std::uint64_t(0));
+    });
+    scan("StableVector, by chunks    ", count, [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t c = 0; c < stable.chunkCount(); ++c) {
+            const std::uint64_t* chunk = stable.chunk(c);
+            std::size_t size = std::min(stable.chunkSize, stable.size() - c * stable.chunkSize);
+            for (std::size_t i = 0; i < size; ++i) {
+                sum += chunk[i];
+            }
+        }
+        return sum;
+    });
+}
@@ -0,0 +1,45 @@
+﻿// Заполнение коротких векторов: Vector с заранее вызванным reserve против StaticVector
+// (с проверкой переполнения и без неё). Печатает время на один вектор.
+
+#include <chrono>
+#include <iostream>
+
+#include "static_vector.hpp"
+#include "vector.hpp"
+
+template<typename Container, bool Reserve>
+void run(const char* name, std::size_t count)
+{
+    const std::size_t repeats = 1000000;
+
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t r = 0; r < repeats; ++r) {
+        Container v;
+        if constexpr (Reserve) {
+            v.reserve(count);
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            v.pushBack(static_cast<int>(i ^ r));
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            checksum += v[i];
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / repeats;
+    std::cout << name << " size " << count << ": " << ns << " ns (checksum " << checksum << ")\n";
+}
+
+
+
+int main()
+{
+    for (std::size_t count : {1, 4, 16, 64}) {
+        run<Vector<int>, true>("Vector + reserve            ", count);
+        run<StaticVector<int, 64>, false>("StaticVector<64>            ", count);
+        run<StaticVector<int, 64, UncheckedOverflow>, false>("StaticVector<64>, unchecked ", count);
+    }
+    return 0;
+}
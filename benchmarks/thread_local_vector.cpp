@@ -0,0 +1,86 @@
+﻿// Параллельный цикл, в котором каждый поток отбирает элементы в свой буфер, и склейка
+// буферов в один Vector: ThreadLocalVector::combine последовательно и в параллельном режиме
+// (parallel::enable) против ручной схемы "буферы потоков + последовательный append".
+// Выигрыш склейки зависит от числа ядер и пропускной способности памяти.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "parallel.hpp"
+#include "thread_local_vector.hpp"
+#include "vector.hpp"
+
+volatile std::uint64_t sink;
+
+
+
+template<typename Function>
+double milliseconds(Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+// Каждый поток добавляет perThread элементов в свой буфер, полученный от local(shard)
+template<typename Local>
+void fill(unsigned threads, std::size_t perThread, Local local)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([=] {
+            auto& buffer = local(t);
+            for (std::uint64_t i = 0; i < perThread; ++i) {
+                buffer.pushBack(i * 2654435761u + t);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+
+int main()
+{
+    const unsigned threads = 8;
+    const std::size_t perThread = (std::size_t(1) << 27) / threads;
+    std::cout << threads << " threads, " << perThread * threads * sizeof(std::uint64_t) / (1 << 20) << " MB\n";
+
+    {
+        std::vector<Vector<std::uint64_t>> buffers(threads);
+        double append = milliseconds([&] {
+            fill(threads, perThread, [&](unsigned t) -> Vector<std::uint64_t>& { return buffers[t]; });
+        });
+        double concat = milliseconds([&] {
+            Vector<std::uint64_t> result;
+            result.reserve(perThread * threads);
+            for (auto& buffer : buffers) {
+                result.append(buffer.data(), buffer.size());
+            }
+            sink = result[result.size() - 1];
+        });
+        std::cout << "    hand-rolled buffers: append " << append << " ms, serial concat " << concat << " ms\n";
+    }
+
+    ThreadLocalVector<std::uint64_t> shards;
+    double append = milliseconds([&] {
+        fill(threads, perThread, [&](unsigned) -> Vector<std::uint64_t>& { return shards.local(); });
+    });
+    double serial = milliseconds([&] {
+        sink = shards.combine().size();
+    });
+    parallel::enable(16 * 1024 * 1024, threads);
+    double parallelCombine = milliseconds([&] {
+        sink = shards.combine().size();
+    });
+    std::cout << "    ThreadLocalVector  : append " << append << " ms, combine " << serial
+              << " ms, parallel combine (" << parallel::threadsFor(perThread * threads * sizeof(std::uint64_t))
+              << " threads) " << parallelCombine << " ms\n";
+}
@@ -0,0 +1,733 @@
+﻿#ifndef ALLOCATORS_HPP
+#define ALLOCATORS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+#include "numa.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Аллокатор на malloc/realloc, а для блоков от MmapThreshold байт - на анонимном mmap.
+// Умеет reallocate: Vector использует его для тривиально переносимых типов, и тогда
+// рост буфера делает realloc/mremap - ядро переотображает страницы вместо копирования
+template<typename Type, std::size_t MmapThreshold = 64 * 1024 * 1024>
+class MallocAllocator
+{
+  public:
+
+    using value_type = Type;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = MallocAllocator<Other, MmapThreshold>;
+    };
+
+    MallocAllocator() = default;
+
+    template<typename Other>
+    MallocAllocator(const MallocAllocator<Other, MmapThreshold>&) {}
+
+    // Выделяет память под count элементов
+    Type* allocate(std::size_t count);
+
+    // Выделяет обнулённую память под count элементов (calloc или mmap): ядро отдаёт
+    // нулевые страницы лениво, при первом обращении к ним
+    Type* allocateZeroed(std::size_t count);
+
+    // Освобождает память, выделенную allocate/reallocate с тем же count
+    void deallocate(Type* data, std::size_t count);
+
+    // Меняет размер блока с oldCount до newCount элементов, по возможности на месте.
+    // Содержимое переносится побитово, поэтому годится только для тривиально переносимых типов
+    Type* reallocate(Type* data, std::size_t oldCount, std::size_t newCount);
+
+  private:
+
+    static_assert(alignof(Type) <= alignof(std::max_align_t), "MallocAllocator does not support over-aligned types");
+
+    // Блоки от MmapThreshold байт выделяются через mmap
+    static bool isMapped(std::size_t bytes);
+
+    // Размер отображения, округлённый до страницы
+    static std::size_t mappedSize(std::size_t bytes);
+};
+
+
+
+template<typename Type, typename Other, std::size_t MmapThreshold>
+bool operator==(const MallocAllocator<Type, MmapThreshold>&, const MallocAllocator<Other, MmapThreshold>&)
+{
+    return true;
+}
+
+
+
+template<typename Type, typename Other, std::size_t MmapThreshold>
+bool operator!=(const MallocAllocator<Type, MmapThreshold>&, const MallocAllocator<Other, MmapThreshold>&)
+{
+    return false;
+}
+
+
+
+// Аллокатор, выравнивающий начало буфера по Alignment байт (по умолчанию - по кэш-линии,
+// чего достаточно для выровненных загрузок AVX-512)
+template<typename Type, std::size_t Alignment = 64>
+class AlignedAllocator
+{
+  public:
+
+    using value_type = Type;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = AlignedAllocator<Other, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template<typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment>&) {}
+
+    // Выделяет выровненную память под count элементов
+    Type* allocate(std::size_t count);
+
+    // Освобождает память, выделенную allocate
+    void deallocate(Type* data, std::size_t count);
+
+  private:
+
+    static_assert(Alignment >= alignof(Type) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two not less than alignof(Type)");
+};
+
+
+
+template<typename Type, typename Other, std::size_t Alignment>
+bool operator==(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&)
+{
+    return true;
+}
+
+
+
+template<typename Type, typename Other, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&)
+{
+    return false;
+}
+
+
+
+// Аллокатор для очень больших буферов: блоки от ThresholdBytes отображаются через mmap,
+// выравниваются по 2 МБ и помечаются madvise(MADV_HUGEPAGE), чтобы ядро подложило
+// прозрачные огромные страницы (меньше промахов TLB). Меньшие блоки выравниваются по 64 байта
+template<typename Type, std::size_t ThresholdBytes = 4 * 1024 * 1024>
+class HugePageAllocator
+{
+  public:
+
+    using value_type = Type;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = HugePageAllocator<Other, ThresholdBytes>;
+    };
+
+    HugePageAllocator() = default;
+
+    template<typename Other>
+    HugePageAllocator(const HugePageAllocator<Other, ThresholdBytes>&) {}
+
+    // Выделяет память под count элементов
+    Type* allocate(std::size_t count);
+
+    // Освобождает память, выделенную allocate с тем же count
+    void deallocate(Type* data, std::size_t count);
+
+  private:
+
+    static_assert(alignof(Type) <= 64, "HugePageAllocator does not support alignment above 64 bytes");
+
+    // Размер огромной страницы x86-64
+    static constexpr std::size_t hugePageBytes = 2 * 1024 * 1024;
+
+    // Блоки от ThresholdBytes выделяются через mmap
+    static bool isMapped(std::size_t bytes);
+};
+
+
+
+template<typename Type, typename Other, std::size_t ThresholdBytes>
+bool operator==(const HugePageAllocator<Type, ThresholdBytes>&, const HugePageAllocator<Other, ThresholdBytes>&)
+{
+    return true;
+}
+
+
+
+template<typename Type, typename Other, std::size_t ThresholdBytes>
+bool operator!=(const HugePageAllocator<Type, ThresholdBytes>&, const HugePageAllocator<Other, ThresholdBytes>&)
+{
+    return false;
+}
+
+
+
+// Аллокатор, размещающий блоки от ThresholdBytes на узлах NUMA по политике NumaPolicy: блок
+// отображается через mmap и до первого касания привязывается mbind. Меньшие блоки берутся
+// из operator new без привязки. Если привязать не удалось (один узел, запрет mbind), блок
+// остаётся обычной анонимной памятью. Аллокаторы с разными политиками не равны, поэтому
+// перемещение Vector между ними переносит элементы в память целевой политики
+template<typename Type, std::size_t ThresholdBytes = 1024 * 1024>
+class NumaAllocator
+{
+  public:
+
+    using value_type = Type;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = NumaAllocator<Other, ThresholdBytes>;
+    };
+
+    NumaAllocator() = default;
+
+    // Аллокатор с политикой policy
+    explicit NumaAllocator(const NumaPolicy& policy);
+
+    template<typename Other>
+    NumaAllocator(const NumaAllocator<Other, ThresholdBytes>& other);
+
+    // Выделяет память под count элементов
+    Type* allocate(std::size_t count);
+
+    // Освобождает память, выделенную allocate с тем же count
+    void deallocate(Type* data, std::size_t count);
+
+    // Политика размещения блоков
+    const NumaPolicy& policy() const;
+
+  private:
+
+    // Блоки от ThresholdBytes выделяются через mmap
+    static bool isMapped(std::size_t bytes);
+
+    // Размер отображения под bytes байт - целое число страниц
+    static std::size_t mappedBytes(std::size_t bytes);
+
+    NumaPolicy policy_;
+};
+
+
+
+template<typename Type, typename Other, std::size_t ThresholdBytes>
+bool operator==(const NumaAllocator<Type, ThresholdBytes>& left, const NumaAllocator<Other, ThresholdBytes>& right)
+{
+    return left.policy() == right.policy();
+}
+
+
+
+template<typename Type, typename Other, std::size_t ThresholdBytes>
+bool operator!=(const NumaAllocator<Type, ThresholdBytes>& left, const NumaAllocator<Other, ThresholdBytes>& right)
+{
+    return !(left == right);
+}
+
+
+
+// Монотонная арена: выделение - сдвиг указателя внутри блока, освобождение отдельных
+// объектов ничего не делает (кроме последнего выделенного), release() и деструктор
+// возвращают всю память разом. Умеет expand: последний выделенный блок растёт на месте,
+// и pmr::Vector пользуется этим в reserve
+class MonotonicArena : public std::pmr::memory_resource
+{
+  public:
+
+    // Арена, берущая блоки от initialBytes байт (с геометрическим ростом) у upstream
+    explicit MonotonicArena(std::size_t initialBytes = 64 * 1024,
+                            std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+    MonotonicArena(const MonotonicArena&) = delete;
+
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    // Деструктор: освобождает всю память арены
+    ~MonotonicArena() override;
+
+    // Освобождает всю память арены; все выделенные из неё объекты становятся недействительными
+    void release();
+
+    // Меняет размер последнего выделенного блока data с oldBytes до newBytes на месте.
+    // Возвращает false, если data - не последний блок или в текущем блоке не хватает места
+    bool expand(void* data, std::size_t oldBytes, std::size_t newBytes);
+
+    // Сколько байт сейчас выделено у upstream
+    std::size_t reservedBytes() const;
+
+  private:
+
+    // Заголовок блока памяти, полученного от upstream
+    struct Chunk
+    {
+        Chunk* previous;
+        std::size_t bytes;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void* data, std::size_t bytes, std::size_t alignment) override;
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    // Берёт у upstream новый блок, в который поместится bytes байт с выравниванием alignment
+    void addChunk(std::size_t bytes, std::size_t alignment);
+
+    // Источник блоков
+    std::pmr::memory_resource* upstream_;
+
+    // Последний полученный блок (голова списка)
+    Chunk* chunks_;
+
+    // Свободная часть текущего блока: [current_, end_)
+    char* current_;
+    char* end_;
+
+    // Размер следующего блока
+    std::size_t nextChunkBytes_;
+
+    // Сколько байт сейчас выделено у upstream
+    std::size_t reservedBytes_;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t MmapThreshold>
+Type* MallocAllocator<Type, MmapThreshold>::allocate(std::size_t count)
+{
+    if (count > std::size_t(-1) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+    std::size_t bytes = count * sizeof(Type);
+
+#if defined(__linux__)
+    if (isMapped(bytes)) {
+        void* data = mmap(nullptr, mappedSize(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(data);
+    }
+#endif
+
+    void* data = std::malloc(bytes);
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<Type*>(data);
+}
+
+
+
+template<typename Type, std::size_t MmapThreshold>
+Type* MallocAllocator<Type, MmapThreshold>::allocateZeroed(std::size_t count)
+{
+    if (count > std::size_t(-1) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+
+    // Анонимное отображение и так состоит из нулевых страниц
+    if (isMapped(count * sizeof(Type))) {
+        return allocate(count);
+    }
+
+    void* data = std::calloc(count, sizeof(Type));
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<Type*>(data);
+}
+
+
+
+template<typename Type, std::size_t MmapThreshold>
+void MallocAllocator<Type, MmapThreshold>::deallocate(Type* data, std::size_t count)
+{
+#if defined(__linux__)
+    std::size_t bytes = count * sizeof(Type);
+    if (isMapped(bytes)) {
+        munmap(data, mappedSize(bytes));
+        return;
+    }
+#else
+    (void)count;
+#endif
+
+    std::free(data);
+}
+
+
+
+template<typename Type, std::size_t MmapThreshold>
+Type* MallocAllocator<Type, MmapThreshold>::reallocate(Type* data, std::size_t oldCount, std::size_t newCount)
+{
+    if (newCount > std::size_t(-1) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+    std::size_t oldBytes = oldCount * sizeof(Type);
+    std::size_t newBytes = newCount * sizeof(Type);
+
+    if (!isMapped(oldBytes) && !isMapped(newBytes)) {
+        void* newData = std::realloc(data, newBytes);
+        if (newData == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(newData);
+    }
+
+#if defined(__linux__)
+    if (isMapped(oldBytes) && isMapped(newBytes)) {
+        void* newData = mremap(data, mappedSize(oldBytes), mappedSize(newBytes), MREMAP_MAYMOVE);
+        if (newData == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(newData);
+    }
+#endif
+
+    // Блок переходит между malloc и mmap - копируем
+    Type* newData = allocate(newCount);
+    std::memcpy(static_cast<void*>(newData), static_cast<const void*>(data), std::min(oldBytes, newBytes));
+    deallocate(data, oldCount);
+    return newData;
+}
+
+
+
+template<typename Type, std::size_t MmapThreshold>
+bool MallocAllocator<Type, MmapThreshold>::isMapped(std::size_t bytes)
+{
+#if defined(__linux__)
+    return bytes >= MmapThreshold;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+
+
+template<typename Type, std::size_t MmapThreshold>
+std::size_t MallocAllocator<Type, MmapThreshold>::mappedSize(std::size_t bytes)
+{
+#if defined(__linux__)
+    static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return (bytes + pageSize - 1) / pageSize * pageSize;
+#else
+    return bytes;
+#endif
+}
+//***************************************************************************//
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t Alignment>
+Type* AlignedAllocator<Type, Alignment>::allocate(std::size_t count)
+{
+    if (count > std::size_t(-1) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+    return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t(Alignment)));
+}
+
+
+
+template<typename Type, std::size_t Alignment>
+void AlignedAllocator<Type, Alignment>::deallocate(Type* data, std::size_t)
+{
+    ::operator delete(data, std::align_val_t(Alignment));
+}
+//***************************************************************************//
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t ThresholdBytes>
+Type* HugePageAllocator<Type, ThresholdBytes>::allocate(std::size_t count)
+{
+    if (count > (std::size_t(-1) - 2 * hugePageBytes) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+    std::size_t bytes = count * sizeof(Type);
+
+#if defined(__linux__)
+    if (isMapped(bytes)) {
+        // Отображаем с запасом в одну огромную страницу и обрезаем края до границ 2 МБ
+        std::size_t mapped = (bytes + hugePageBytes - 1) / hugePageBytes * hugePageBytes;
+        void* raw = mmap(nullptr, mapped + hugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        char* begin = static_cast<char*>(raw);
+        char* aligned = reinterpret_cast<char*>(
+            (reinterpret_cast<std::uintptr_t>(begin) + hugePageBytes - 1) / hugePageBytes * hugePageBytes);
+        if (aligned != begin) {
+            munmap(begin, static_cast<std::size_t>(aligned - begin));
+        }
+        std::size_t tail = static_cast<std::size_t>(begin + mapped + hugePageBytes - (aligned + mapped));
+        if (tail != 0) {
+            munmap(aligned + mapped, tail);
+        }
+#if defined(MADV_HUGEPAGE)
+        // Без поддержки THP ядро вернёт ошибку - тогда остаются обычные страницы
+        madvise(aligned, mapped, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<Type*>(aligned);
+    }
+#endif
+
+    return static_cast<Type*>(::operator new(bytes, std::align_val_t(64)));
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+void HugePageAllocator<Type, ThresholdBytes>::deallocate(Type* data, std::size_t count)
+{
+    std::size_t bytes = count * sizeof(Type);
+
+#if defined(__linux__)
+    if (isMapped(bytes)) {
+        munmap(data, (bytes + hugePageBytes - 1) / hugePageBytes * hugePageBytes);
+        return;
+    }
+#endif
+
+    ::operator delete(data, std::align_val_t(64));
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+bool HugePageAllocator<Type, ThresholdBytes>::isMapped(std::size_t bytes)
+{
+#if defined(__linux__)
+    return bytes >= ThresholdBytes;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+//***************************************************************************//
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t ThresholdBytes>
+NumaAllocator<Type, ThresholdBytes>::NumaAllocator(const NumaPolicy& policy)
+    : policy_(policy)
+{
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+template<typename Other>
+NumaAllocator<Type, ThresholdBytes>::NumaAllocator(const NumaAllocator<Other, ThresholdBytes>& other)
+    : policy_(other.policy())
+{
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+Type* NumaAllocator<Type, ThresholdBytes>::allocate(std::size_t count)
+{
+    if (count > (std::size_t(-1) - static_cast<std::size_t>(numa::detail::pageBytes())) / sizeof(Type)) {
+        throw std::bad_alloc();
+    }
+    std::size_t bytes = count * sizeof(Type);
+
+#if defined(__linux__)
+    if (isMapped(bytes)) {
+        void* data = mmap(nullptr, mappedBytes(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (policy_.mode != NumaPolicy::Mode::Default) {
+            numa::bind(data, mappedBytes(bytes), policy_);
+        }
+        return static_cast<Type*>(data);
+    }
+#endif
+
+    return static_cast<Type*>(::operator new(bytes, std::align_val_t(alignof(Type))));
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+void NumaAllocator<Type, ThresholdBytes>::deallocate(Type* data, std::size_t count)
+{
+    std::size_t bytes = count * sizeof(Type);
+
+#if defined(__linux__)
+    if (isMapped(bytes)) {
+        munmap(data, mappedBytes(bytes));
+        return;
+    }
+#endif
+
+    ::operator delete(data, std::align_val_t(alignof(Type)));
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+const NumaPolicy& NumaAllocator<Type, ThresholdBytes>::policy() const
+{
+    return policy_;
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+bool NumaAllocator<Type, ThresholdBytes>::isMapped(std::size_t bytes)
+{
+#if defined(__linux__)
+    return bytes >= ThresholdBytes && bytes > 0;
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+
+
+template<typename Type, std::size_t ThresholdBytes>
+std::size_t NumaAllocator<Type, ThresholdBytes>::mappedBytes(std::size_t bytes)
+{
+    std::size_t page = static_cast<std::size_t>(numa::detail::pageBytes());
+    return (bytes + page - 1) / page * page;
+}
+//***************************************************************************//
+
+
+
+//***************************************************************************//
+inline MonotonicArena::MonotonicArena(std::size_t initialBytes, std::pmr::memory_resource* upstream)
+    : upstream_{upstream}, chunks_{nullptr}, current_{nullptr}, end_{nullptr},
+      nextChunkBytes_{std::max<std::size_t>(initialBytes, 256)}, reservedBytes_{0}
+{
+}
+
+
+
+inline MonotonicArena::~MonotonicArena()
+{
+    release();
+}
+
+
+
+inline void MonotonicArena::release()
+{
+    while (chunks_ != nullptr) {
+        Chunk* previous = chunks_->previous;
+        upstream_->deallocate(chunks_, chunks_->bytes, alignof(std::max_align_t));
+        chunks_ = previous;
+    }
+    current_ = nullptr;
+    end_ = nullptr;
+    reservedBytes_ = 0;
+}
+
+
+
+inline bool MonotonicArena::expand(void* data, std::size_t oldBytes, std::size_t newBytes)
+{
+    char* begin = static_cast<char*>(data);
+    if (begin + oldBytes != current_ || newBytes > static_cast<std::size_t>(end_ - begin)) {
+        return false;
+    }
+    current_ = begin + newBytes;
+    return true;
+}
+
+
+
+inline std::size_t MonotonicArena::reservedBytes() const
+{
+    return reservedBytes_;
+}
+
+
+
+inline void* MonotonicArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t space = static_cast<std::size_t>(end_ - current_);
+    void* data = current_;
+    if (current_ == nullptr || std::align(alignment, bytes, data, space) == nullptr) {
+        addChunk(bytes, alignment);
+        space = static_cast<std::size_t>(end_ - current_);
+        data = current_;
+        std::align(alignment, bytes, data, space);
+    }
+    current_ = static_cast<char*>(data) + bytes;
+    return data;
+}
+
+
+
+inline void MonotonicArena::do_deallocate(void* data, std::size_t bytes, std::size_t)
+{
+    // Последний выделенный блок можно вернуть сразу - так переиспользуются временные буферы
+    if (static_cast<char*>(data) + bytes == current_) {
+        current_ = static_cast<char*>(data);
+    }
+}
+
+
+
+inline bool MonotonicArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+
+
+inline void MonotonicArena::addChunk(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t needed = sizeof(Chunk) + bytes + alignment;
+    while (nextChunkBytes_ < needed) {
+        nextChunkBytes_ *= 2;
+    }
+
+    void* memory = upstream_->allocate(nextChunkBytes_, alignof(std::max_align_t));
+    Chunk* chunk = ::new (memory) Chunk{chunks_, nextChunkBytes_};
+    chunks_ = chunk;
+    current_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = static_cast<char*>(memory) + nextChunkBytes_;
+    reservedBytes_ += nextChunkBytes_;
+    nextChunkBytes_ *= 2;
+}
+//***************************************************************************//
+
+#endif // ALLOCATORS_HPP
@@ -0,0 +1,143 @@
+﻿#ifndef CLAIM_WRITER_HPP
+#define CLAIM_WRITER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Параллельная запись в вектор, итоговый размер которого известен заранее. Конструктор
+// резервирует место под capacity элементов за текущим концом вектора; потоки занимают
+// непересекающиеся отрезки этого места атомарным fetch_add на курсоре (claim), записывают
+// элементы без блокировок и сообщают, сколько записали (publish). finalize() в одном потоке
+// после завершения записи увеличивает size() вектора на число занятых элементов.
+//
+// Элементы записываются присваиванием или memcpy в неинициализированную память, поэтому тип
+// должен быть тривиально копируемым и тривиально уничтожаемым. Пока идёт запись, вектор нельзя
+// изменять и переаллоцировать
+template<typename VectorType>
+class ClaimWriter
+{
+  public:
+
+    using value_type = typename VectorType::value_type;
+
+    // Отрезок памяти, занятый одним вызовом claim
+    struct Span
+    {
+        value_type* data;
+        std::size_t size;
+
+        value_type* begin() const
+        {
+            return data;
+        }
+
+        value_type* end() const
+        {
+            return data + size;
+        }
+
+        value_type& operator[](std::size_t index) const
+        {
+            return data[index];
+        }
+    };
+
+    // Резервирует в vector место под capacity элементов за текущим размером
+    ClaimWriter(VectorType& vector, std::size_t capacity);
+
+    ClaimWriter(const ClaimWriter&) = delete;
+
+    ClaimWriter& operator=(const ClaimWriter&) = delete;
+
+    // Атомарно занимает count элементов и возвращает их память. Если места не хватает,
+    // бросает "LengthError"; курсор при этом остаётся сдвинутым и finalize() бросит "LogicError"
+    Span claim(std::size_t count);
+
+    // Сообщает, что count занятых элементов записаны
+    void publish(std::size_t count);
+
+    // Число занятых элементов
+    std::size_t claimed() const;
+
+    // Увеличивает размер вектора на число занятых элементов и возвращает новый размер.
+    // Бросает "LogicError", если записаны не все занятые элементы. Вызывается один раз,
+    // когда все потоки закончили запись
+    std::size_t finalize();
+
+  private:
+
+    static_assert(std::is_trivially_copyable<value_type>::value && std::is_trivially_destructible<value_type>::value,
+                  "ClaimWriter requires a trivially copyable and destructible type");
+
+    VectorType& vector_;
+
+    // Первый элемент зарезервированной области
+    value_type* base_;
+
+    std::size_t capacity_;
+
+    // Курсор и счётчик записанных элементов - в разных кэш-линиях: claim и publish
+    // разных потоков не мешают друг другу
+    alignas(64) std::atomic<std::size_t> cursor_;
+
+    alignas(64) std::atomic<std::size_t> published_;
+};
+
+
+
+//***************************************************************************//
+template<typename VectorType>
+ClaimWriter<VectorType>::ClaimWriter(VectorType& vector, std::size_t capacity)
+    : vector_(vector), base_(nullptr), capacity_(capacity), cursor_(0), published_(0)
+{
+    if (capacity > vector.maxSize() - vector.size()) {
+        throw "LengthError";
+    }
+    vector.reserve(vector.size() + capacity);
+    base_ = vector.data() + vector.size();
+}
+
+
+
+template<typename VectorType>
+typename ClaimWriter<VectorType>::Span ClaimWriter<VectorType>::claim(std::size_t count)
+{
+    std::size_t first = cursor_.fetch_add(count, std::memory_order_relaxed);
+    if (first > capacity_ || count > capacity_ - first) {
+        throw "LengthError";
+    }
+    return Span{base_ + first, count};
+}
+
+
+
+template<typename VectorType>
+void ClaimWriter<VectorType>::publish(std::size_t count)
+{
+    published_.fetch_add(count, std::memory_order_release);
+}
+
+
+
+template<typename VectorType>
+std::size_t ClaimWriter<VectorType>::claimed() const
+{
+    return cursor_.load(std::memory_order_relaxed);
+}
+
+
+
+template<typename VectorType>
+std::size_t ClaimWriter<VectorType>::finalize()
+{
+    std::size_t count = cursor_.load(std::memory_order_relaxed);
+    if (count > capacity_ || published_.load(std::memory_order_acquire) != count) {
+        throw "LogicError";
+    }
+    vector_.commitOverwritten(count);
+    return vector_.size();
+}
+//***************************************************************************//
+
+#endif // CLAIM_WRITER_HPP
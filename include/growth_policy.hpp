@@ -0,0 +1,225 @@
+﻿#ifndef GROWTH_POLICY_HPP
+#define GROWTH_POLICY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Политики роста вместимости Vector. Каждая политика - класс со статическими методами:
+//   grow(capacity, required, maxSize, elementSize) - новая вместимость, не меньше required
+//   shrink(capacity, count, elementSize) - вместимость после shrinkToFit, не меньше count
+
+
+
+// Удвоение вместимости; shrinkToFit сокращает до 2^round(log2(count))
+struct DoublingGrowth
+{
+    static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t elementSize);
+
+    static std::size_t shrink(std::size_t capacity, std::size_t count, std::size_t elementSize);
+};
+
+
+
+// Рост в 1.5 раза: сумма ранее освобождённых блоков со временем превышает новый запрос,
+// и аллокатор может переиспользовать их память; shrinkToFit сокращает ровно до count
+struct GoldenGrowth
+{
+    static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t elementSize);
+
+    static std::size_t shrink(std::size_t capacity, std::size_t count, std::size_t elementSize);
+};
+
+
+
+// Политика Base, вместимость которой округляется вверх до класса размера malloc
+// (malloc_usable_size): хвост блока, который аллокатор всё равно отдал бы, становится вместимостью
+template<typename Base = DoublingGrowth>
+struct SizeClassGrowth
+{
+    static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t elementSize);
+
+    static std::size_t shrink(std::size_t capacity, std::size_t count, std::size_t elementSize);
+
+  private:
+
+    // Вместимость блока, который malloc на самом деле выделит под count элементов
+    static std::size_t usableCount(std::size_t count, std::size_t maxSize, std::size_t elementSize);
+};
+
+
+
+// До ThresholdMegabytes удваивает вместимость, выше - растёт на 1/8 с округлением до страницы,
+// ограничивая неиспользуемый хвост больших буферов. Лучше всего сочетается с MallocAllocator,
+// у которого частые переаллокации больших буферов сводятся к mremap
+template<std::size_t ThresholdMegabytes = 64>
+struct PageGranularGrowth
+{
+    static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t elementSize);
+
+    static std::size_t shrink(std::size_t capacity, std::size_t count, std::size_t elementSize);
+
+  private:
+
+    static constexpr std::size_t thresholdBytes = ThresholdMegabytes * 1024 * 1024;
+
+    // Округляет count вверх так, чтобы буфер занимал целое число страниц
+    static std::size_t roundToPages(std::size_t count, std::size_t maxSize, std::size_t elementSize);
+};
+
+
+
+//***************************************************************************//
+inline std::size_t DoublingGrowth::grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t)
+{
+    std::size_t newCapacity = capacity * 2;
+    if (newCapacity == 0) {
+        newCapacity = 1;
+    }
+    if (capacity > maxSize / 2) {
+        return maxSize;
+    }
+    while (required > newCapacity) {
+        if (newCapacity > maxSize / 2) {
+            return maxSize;
+        }
+        newCapacity *= 2;
+    }
+    return newCapacity;
+}
+
+
+
+inline std::size_t DoublingGrowth::shrink(std::size_t capacity, std::size_t count, std::size_t)
+{
+    if (count > (capacity / 2)) {
+        return capacity;
+    }
+
+    std::size_t newCapacity = capacity / 2;
+    while (count <= (newCapacity / 2)) {
+        newCapacity /= 2;
+    }
+    return newCapacity;
+}
+
+
+
+inline std::size_t GoldenGrowth::grow(std::size_t capacity, std::size_t required, std::size_t maxSize, std::size_t)
+{
+    if (capacity > maxSize / 3 * 2) {
+        return maxSize;
+    }
+    return std::max(required, capacity + capacity / 2);
+}
+
+
+
+inline std::size_t GoldenGrowth::shrink(std::size_t, std::size_t count, std::size_t)
+{
+    return count;
+}
+
+
+
+template<typename Base>
+std::size_t SizeClassGrowth<Base>::grow(std::size_t capacity, std::size_t required, std::size_t maxSize,
+                                        std::size_t elementSize)
+{
+    return usableCount(Base::grow(capacity, required, maxSize, elementSize), maxSize, elementSize);
+}
+
+
+
+template<typename Base>
+std::size_t SizeClassGrowth<Base>::shrink(std::size_t capacity, std::size_t count, std::size_t elementSize)
+{
+    std::size_t newCapacity = Base::shrink(capacity, count, elementSize);
+    if (newCapacity == capacity) {
+        return capacity;
+    }
+    return std::min(capacity, usableCount(newCapacity, capacity, elementSize));
+}
+
+
+
+template<typename Base>
+std::size_t SizeClassGrowth<Base>::usableCount(std::size_t count, std::size_t maxSize, std::size_t elementSize)
+{
+#if defined(__GLIBC__)
+    if (count == 0 || count > std::size_t(-1) / elementSize) {
+        return count;
+    }
+    // Пробный блок того же размера: сразу после free его заберёт настоящая аллокация
+    void* probe = std::malloc(count * elementSize);
+    if (probe == nullptr) {
+        return count;
+    }
+    std::size_t usable = malloc_usable_size(probe) / elementSize;
+    std::free(probe);
+    return std::min(std::max(usable, count), maxSize);
+#else
+    (void)maxSize;
+    (void)elementSize;
+    return count;
+#endif
+}
+
+
+
+template<std::size_t ThresholdMegabytes>
+std::size_t PageGranularGrowth<ThresholdMegabytes>::grow(std::size_t capacity, std::size_t required,
+                                                         std::size_t maxSize, std::size_t elementSize)
+{
+    if (capacity <= thresholdBytes / elementSize) {
+        std::size_t newCapacity = DoublingGrowth::grow(capacity, required, maxSize, elementSize);
+        if (newCapacity <= thresholdBytes / elementSize) {
+            return newCapacity;
+        }
+    }
+    if (capacity > maxSize / 9 * 8) {
+        return maxSize;
+    }
+    return roundToPages(std::max(required, capacity + capacity / 8), maxSize, elementSize);
+}
+
+
+
+template<std::size_t ThresholdMegabytes>
+std::size_t PageGranularGrowth<ThresholdMegabytes>::shrink(std::size_t capacity, std::size_t count,
+                                                           std::size_t elementSize)
+{
+    if (count <= thresholdBytes / elementSize) {
+        return DoublingGrowth::shrink(capacity, count, elementSize);
+    }
+    return std::min(capacity, roundToPages(count, capacity, elementSize));
+}
+
+
+
+template<std::size_t ThresholdMegabytes>
+std::size_t PageGranularGrowth<ThresholdMegabytes>::roundToPages(std::size_t count, std::size_t maxSize,
+                                                                 std::size_t elementSize)
+{
+#if defined(__linux__)
+    static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    static const std::size_t pageSize = 4096;
+#endif
+    if (count > (std::size_t(-1) - pageSize) / elementSize) {
+        return count;
+    }
+    std::size_t bytes = (count * elementSize + pageSize - 1) / pageSize * pageSize;
+    return std::max(count, std::min(bytes / elementSize, maxSize));
+}
+//***************************************************************************//
+
+#endif // GROWTH_POLICY_HPP
@@ -0,0 +1,572 @@
+﻿#ifndef INCREMENTAL_VECTOR_HPP
+#define INCREMENTAL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "growth_policy.hpp"
+#include "vector.hpp"
+
+// Вектор с постепенной переаллокацией для добавлений, чувствительных к задержке. Когда место
+// кончается, выделяется новый буфер по GrowthPolicy, но старые элементы в него сразу не
+// переносятся: каждое следующее добавление переносит не больше MigrateStep из них, а чтение
+// по индексу, пока перенос не закончен, выбирает буфер одним сравнением. Так вместо одного
+// pushBack, копирующего весь массив, задержка распределяется по многим добавлениям.
+//
+// Новый буфер заполняется не раньше, чем перенос закончится, если GrowthPolicy увеличивает
+// вместимость хотя бы в 1 + 1 / MigrateStep раза; иначе оставшиеся элементы переносятся
+// целиком перед следующим ростом. Память непрерывна только вне переноса, поэтому data() и
+// итераторов-указателей нет. Перенос - detail::relocate, как у Vector: memcpy для
+// тривиально переносимых типов, для остальных move_if_noexcept со строгой гарантией
+template<typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth,
+         std::size_t MigrateStep = 16>
+class IncrementalVector
+{
+  public:
+
+    static_assert(MigrateStep > 0, "MigrateStep must be positive");
+
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+
+    IncrementalVector();
+
+    explicit IncrementalVector(const Allocator& allocator);
+
+    IncrementalVector(const IncrementalVector& other);
+
+    // Копия other с памятью из allocator
+    IncrementalVector(const IncrementalVector& other, const Allocator& allocator);
+
+    IncrementalVector& operator=(const IncrementalVector& other);
+
+    IncrementalVector(IncrementalVector&& other) noexcept;
+
+    IncrementalVector& operator=(IncrementalVector&& other);
+
+    ~IncrementalVector();
+
+    // Добавляет элемент в конец и переносит не больше MigrateStep старых элементов
+    void pushBack(const Type& element);
+
+    void pushBack(Type&& element);
+
+    // Конструирует элемент в конце вектора из args, возвращает ссылку на него
+    template <class ...Args>
+    Type& emplaceBack(Args&&... args);
+
+    // Удаляет последний элемент, бросает "LogicError" у пустого вектора
+    void popBack();
+
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+    std::size_t maxSize() const;
+
+    bool empty() const;
+
+    // Выделяет память как минимум под count элементов сразу, перенося все элементы
+    void reserve(std::size_t count);
+
+    // Уничтожает элементы и освобождает оба буфера
+    void clear();
+
+    // Идёт ли перенос из старого буфера
+    bool migrating() const;
+
+    // Переносит все оставшиеся элементы (например, в момент простоя)
+    void finishMigration();
+
+    // Возвращает ссылку на элемент в позиции index, бросает "IndexOutOfRange"
+    Type& at(std::size_t index);
+
+    const Type& at(std::size_t index) const;
+
+    Type& operator[](std::size_t index);
+
+    const Type& operator[](std::size_t index) const;
+
+    // Бросают "LogicError" у пустого вектора
+    Type& back();
+
+    const Type& back() const;
+
+    // Возвращает копию используемого аллокатора
+    Allocator getAllocator() const;
+
+  private:
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    // Обмен значениями (аллокаторами - только если этого требует propagate_on_container_swap)
+    void swap(IncrementalVector& other);
+
+    // Буфер, в котором лежит элемент index
+    Type* bufferOf(std::size_t index) const;
+
+    // Выделяет новый буфер и создаёт в нём элемент count_ из args, оставляя элементы в старом;
+    // возвращает указатель на созданный элемент
+    template <class ...Args>
+    Type* grow(Args&&... args);
+
+    // Переносит не больше count элементов из старого буфера
+    void migrate(std::size_t count);
+
+    // Освобождает старый буфер, когда в нём не осталось элементов
+    void releaseOld();
+
+    Allocator allocator_;
+
+    // Новый (или единственный) буфер
+    Type* data_;
+
+    std::size_t count_;
+
+    std::size_t capacity_;
+
+    // Старый буфер и его вместимость; nullptr - переноса нет
+    Type* old_;
+
+    std::size_t oldCapacity_;
+
+    // Элементы [migrated_, oldEnd_) ещё лежат в old_, остальные - в data_
+    std::size_t migrated_;
+
+    std::size_t oldEnd_;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector()
+    : IncrementalVector(Allocator())
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(const Allocator& allocator)
+    : allocator_(allocator), data_(nullptr), count_(0), capacity_(0), old_(nullptr), oldCapacity_(0), migrated_(0),
+      oldEnd_(0)
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(const IncrementalVector& other)
+    : IncrementalVector(other, AllocatorTraits::select_on_container_copy_construction(other.allocator_))
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(const IncrementalVector& other,
+                                                                          const Allocator& allocator)
+    : IncrementalVector(allocator)
+{
+    try {
+        reserve(other.count_);
+        for (std::size_t i = 0; i < other.count_; ++i) {
+            pushBack(other[i]);
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>&
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::operator=(const IncrementalVector& other)
+{
+    if (this != &other) {
+        if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+            if (allocator_ != other.allocator_) {
+                clear();
+            }
+            allocator_ = other.allocator_;
+        }
+        IncrementalVector tmp(other, allocator_);
+        swap(tmp);
+    }
+    return *this;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(IncrementalVector&& other) noexcept
+    : IncrementalVector(other.allocator_)
+{
+    swap(other);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>&
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::operator=(IncrementalVector&& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+        clear();
+        allocator_ = other.allocator_;
+    } else if (allocator_ != other.allocator_) {
+        // Буферы other нельзя освободить нашим аллокатором - переносим поэлементно
+        IncrementalVector tmp(allocator_);
+        tmp.reserve(other.count_);
+        for (std::size_t i = 0; i < other.count_; ++i) {
+            tmp.pushBack(std::move(other[i]));
+        }
+        other.clear();
+        swap(tmp);
+        return *this;
+    } else {
+        clear();
+    }
+    swap(other);
+    return *this;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::~IncrementalVector()
+{
+    clear();
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::pushBack(const Type& element)
+{
+    emplaceBack(element);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::pushBack(Type&& element)
+{
+    emplaceBack(std::move(element));
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+template <class ...Args>
+Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::emplaceBack(Args&&... args)
+{
+    Type* place;
+    if (count_ == capacity_) {
+        if (capacity_ == maxSize()) {
+            throw "LengthError";
+        }
+        place = grow(std::forward<Args>(args)...);
+    } else {
+        place = data_ + count_;
+        AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+    }
+
+    // Шаг переноса - после создания элемента: args может ссылаться на элемент старого буфера
+    if (old_ != nullptr) {
+        try {
+            migrate(MigrateStep);
+        } catch (...) {
+            AllocatorTraits::destroy(allocator_, place);
+            throw;
+        }
+    }
+    ++count_;
+    return *place;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::popBack()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+
+    --count_;
+    AllocatorTraits::destroy(allocator_, bufferOf(count_) + count_);
+    if (count_ < oldEnd_) {
+        oldEnd_ = count_;
+        releaseOld();
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+std::size_t IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::size() const
+{
+    return count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+std::size_t IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::capacity() const
+{
+    return capacity_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+std::size_t IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::maxSize() const
+{
+    return AllocatorTraits::max_size(allocator_);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+bool IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::empty() const
+{
+    return count_ == 0;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::reserve(std::size_t count)
+{
+    if (count <= capacity_) {
+        return;
+    }
+    if (count > maxSize()) {
+        throw "LengthError";
+    }
+
+    finishMigration();
+    Type* newData = AllocatorTraits::allocate(allocator_, count);
+    try {
+        detail::relocate(allocator_, data_, count_, newData);
+    } catch (...) {
+        AllocatorTraits::deallocate(allocator_, newData, count);
+        throw;
+    }
+    if (data_ != nullptr) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+    }
+    data_ = newData;
+    capacity_ = count;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::clear()
+{
+    for (std::size_t i = 0; i < count_; ++i) {
+        AllocatorTraits::destroy(allocator_, bufferOf(i) + i);
+    }
+    count_ = 0;
+    oldEnd_ = 0;
+    releaseOld();
+    if (data_ != nullptr) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+bool IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::migrating() const
+{
+    return old_ != nullptr;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::finishMigration()
+{
+    if (old_ != nullptr) {
+        migrate(oldEnd_ - migrated_);
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::at(std::size_t index)
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+    return (*this)[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+const Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::at(std::size_t index) const
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+    return (*this)[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::operator[](std::size_t index)
+{
+    return bufferOf(index)[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+const Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::operator[](std::size_t index) const
+{
+    return bufferOf(index)[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::back()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[count_ - 1];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+const Type& IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::back() const
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[count_ - 1];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+Allocator IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::getAllocator() const
+{
+    return allocator_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::swap(IncrementalVector& other)
+{
+    if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+        std::swap(allocator_, other.allocator_);
+    }
+    std::swap(data_, other.data_);
+    std::swap(count_, other.count_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(old_, other.old_);
+    std::swap(oldCapacity_, other.oldCapacity_);
+    std::swap(migrated_, other.migrated_);
+    std::swap(oldEnd_, other.oldEnd_);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+Type* IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::bufferOf(std::size_t index) const
+{
+    // Вне переноса migrated_ == oldEnd_ == 0, и сравнение всегда выбирает data_
+    return index - migrated_ < oldEnd_ - migrated_ ? old_ : data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+template <class ...Args>
+Type* IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::grow(Args&&... args)
+{
+    std::size_t newCapacity = GrowthPolicy::grow(capacity_, count_ + 1, maxSize(), sizeof(Type));
+    Type* newData = AllocatorTraits::allocate(allocator_, newCapacity);
+    Type* place = newData + count_;
+    try {
+        // Элемент создаётся до того, как перенос тронет старые буферы: args может ссылаться на любой из них
+        AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+    } catch (...) {
+        AllocatorTraits::deallocate(allocator_, newData, newCapacity);
+        throw;
+    }
+    try {
+        // Рост обогнал перенос (медленная GrowthPolicy): закончить предыдущий
+        finishMigration();
+    } catch (...) {
+        AllocatorTraits::destroy(allocator_, place);
+        AllocatorTraits::deallocate(allocator_, newData, newCapacity);
+        throw;
+    }
+
+    if (count_ == 0) {
+        if (data_ != nullptr) {
+            AllocatorTraits::deallocate(allocator_, data_, capacity_);
+        }
+    } else {
+        old_ = data_;
+        oldCapacity_ = capacity_;
+        migrated_ = 0;
+        oldEnd_ = count_;
+    }
+    data_ = newData;
+    capacity_ = newCapacity;
+    return place;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::migrate(std::size_t count)
+{
+    count = std::min(count, oldEnd_ - migrated_);
+    detail::relocate(allocator_, old_ + migrated_, count, data_ + migrated_);
+    migrated_ += count;
+    releaseOld();
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<Type, Allocator, GrowthPolicy, MigrateStep>::releaseOld()
+{
+    if (old_ != nullptr && migrated_ >= oldEnd_) {
+        AllocatorTraits::deallocate(allocator_, old_, oldCapacity_);
+        old_ = nullptr;
+        oldCapacity_ = 0;
+        migrated_ = 0;
+        oldEnd_ = 0;
+    }
+}
+//***************************************************************************//
+
+#endif // INCREMENTAL_VECTOR_HPP
@@ -0,0 +1,286 @@
+﻿#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Размещение памяти на узлах NUMA через системные вызовы mbind, set_mempolicy, get_mempolicy
+// и move_pages напрямую, без libnuma. На машине с одним узлом, без поддержки NUMA в ядре или
+// при запрете вызовов (seccomp) функции возвращают false, а память остаётся там, куда её
+// положила политика по умолчанию (first-touch)
+
+
+
+// Политика размещения страниц
+struct NumaPolicy
+{
+    enum class Mode
+    {
+        // Политика потока (обычно - узел потока, первым коснувшегося страницы)
+        Default,
+        // Только узел node
+        Bind,
+        // Узел node, если на нём есть память, иначе - любой
+        Preferred,
+        // Страницы по очереди на всех узлах
+        Interleave
+    };
+
+    Mode mode = Mode::Default;
+
+    int node = 0;
+
+    static NumaPolicy bind(int node) { return {Mode::Bind, node}; }
+
+    static NumaPolicy preferred(int node) { return {Mode::Preferred, node}; }
+
+    static NumaPolicy interleave() { return {Mode::Interleave, 0}; }
+};
+
+inline bool operator==(const NumaPolicy& left, const NumaPolicy& right)
+{
+    return left.mode == right.mode && (left.mode == NumaPolicy::Mode::Default ||
+                                       left.mode == NumaPolicy::Mode::Interleave || left.node == right.node);
+}
+
+inline bool operator!=(const NumaPolicy& left, const NumaPolicy& right)
+{
+    return !(left == right);
+}
+
+
+
+namespace numa {
+
+// Число узлов (наибольший номер узла в сети + 1); 1, если NUMA не поддерживается
+int nodeCount();
+
+// Применяет policy к страницам [data, data + bytes); data выровнен по странице.
+// Уже выделенные страницы остаются на месте, новые размещаются по политике
+bool bind(void* data, std::size_t bytes, const NumaPolicy& policy);
+
+// Задаёт политику для памяти, которую текущий поток будет выделять дальше
+bool setThreadPolicy(const NumaPolicy& policy);
+
+// Переносит уже выделенные страницы, пересекающие [data, data + bytes), на узел node
+bool movePages(const void* data, std::size_t bytes, int node);
+
+// Узел, на котором лежит страница с адресом data; -1, если неизвестно или страница не выделена
+int nodeOf(const void* data);
+
+
+
+namespace detail {
+
+// Значения из linux/mempolicy.h
+constexpr int mpolDefault = 0;
+constexpr int mpolPreferred = 1;
+constexpr int mpolBind = 2;
+constexpr int mpolInterleave = 3;
+constexpr unsigned mpolFNode = 1u << 0;
+constexpr unsigned mpolFAddr = 1u << 1;
+constexpr int mpolMfMove = 1 << 1;
+
+// Маска узлов для системных вызовов: 1024 узла - с запасом больше CONFIG_NODES_SHIFT=10
+constexpr std::size_t maskBits = 1024;
+constexpr std::size_t maskWords = maskBits / (8 * sizeof(unsigned long));
+
+// Режим и маска узлов политики; false, если номер узла вне маски
+bool policyMask(const NumaPolicy& policy, int& mode, unsigned long* mask);
+
+long pageBytes();
+
+} // namespace detail
+
+} // namespace numa
+
+
+
+//***************************************************************************//
+namespace numa {
+
+inline int nodeCount()
+{
+#if defined(__linux__)
+    static const int count = [] {
+        std::FILE* file = std::fopen("/sys/devices/system/node/online", "r");
+        if (file == nullptr) {
+            return 1;
+        }
+        // Формат: "0", "0-1", "0,2-3" - нужен наибольший номер
+        int highest = 0;
+        int value = 0;
+        char separator = 0;
+        while (std::fscanf(file, "%d%c", &value, &separator) >= 1) {
+            highest = value > highest ? value : highest;
+            if (separator != ',' && separator != '-') {
+                break;
+            }
+            separator = 0;
+        }
+        std::fclose(file);
+        return highest + 1;
+    }();
+    return count;
+#else
+    return 1;
+#endif
+}
+
+
+
+inline bool bind(void* data, std::size_t bytes, const NumaPolicy& policy)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    int mode;
+    unsigned long mask[detail::maskWords];
+    if (!detail::policyMask(policy, mode, mask)) {
+        return false;
+    }
+    unsigned long maxNode = mode == detail::mpolDefault ? 0 : detail::maskBits + 1;
+    return syscall(SYS_mbind, data, bytes, mode, mode == detail::mpolDefault ? nullptr : mask, maxNode, 0) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    (void)policy;
+    return false;
+#endif
+}
+
+
+
+inline bool setThreadPolicy(const NumaPolicy& policy)
+{
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    int mode;
+    unsigned long mask[detail::maskWords];
+    if (!detail::policyMask(policy, mode, mask)) {
+        return false;
+    }
+    unsigned long maxNode = mode == detail::mpolDefault ? 0 : detail::maskBits + 1;
+    return syscall(SYS_set_mempolicy, mode, mode == detail::mpolDefault ? nullptr : mask, maxNode) == 0;
+#else
+    (void)policy;
+    return false;
+#endif
+}
+
+
+
+inline bool movePages(const void* data, std::size_t bytes, int node)
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+    if (node < 0 || node >= nodeCount()) {
+        return false;
+    }
+    if (bytes == 0) {
+        return true;
+    }
+
+    const std::uintptr_t page = static_cast<std::uintptr_t>(detail::pageBytes());
+    std::uintptr_t first = reinterpret_cast<std::uintptr_t>(data) / page * page;
+    std::uintptr_t last = reinterpret_cast<std::uintptr_t>(data) + bytes;
+
+    // Страницы передаются ядру пачками, чтобы не выделять массивы на весь буфер
+    constexpr std::size_t batch = 512;
+    void* pages[batch];
+    int nodes[batch];
+    int status[batch];
+    bool moved = true;
+    while (first < last) {
+        std::size_t count = 0;
+        for (; count < batch && first < last; ++count, first += page) {
+            pages[count] = reinterpret_cast<void*>(first);
+            nodes[count] = node;
+        }
+        if (syscall(SYS_move_pages, 0, count, pages, nodes, status, detail::mpolMfMove) < 0) {
+            return false;
+        }
+        // -ENOENT - страница ещё не выделена: она появится по политике при первом касании
+        for (std::size_t i = 0; i < count; ++i) {
+            if (status[i] < 0 && status[i] != -ENOENT) {
+                moved = false;
+            }
+        }
+    }
+    return moved;
+#else
+    (void)data;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+
+
+
+inline int nodeOf(const void* data)
+{
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, data, detail::mpolFNode | detail::mpolFAddr) != 0) {
+        return -1;
+    }
+    return node;
+#else
+    (void)data;
+    return -1;
+#endif
+}
+
+
+
+namespace detail {
+
+inline bool policyMask(const NumaPolicy& policy, int& mode, unsigned long* mask)
+{
+    for (std::size_t i = 0; i < maskWords; ++i) {
+        mask[i] = 0;
+    }
+
+    constexpr std::size_t wordBits = 8 * sizeof(unsigned long);
+    switch (policy.mode) {
+        case NumaPolicy::Mode::Default:
+            mode = mpolDefault;
+            return true;
+        case NumaPolicy::Mode::Interleave:
+            mode = mpolInterleave;
+            for (int node = 0; node < nodeCount(); ++node) {
+                mask[node / wordBits] |= 1ul << (node % wordBits);
+            }
+            return true;
+        default:
+            if (policy.node < 0 || policy.node >= nodeCount() || static_cast<std::size_t>(policy.node) >= maskBits) {
+                return false;
+            }
+            mode = policy.mode == NumaPolicy::Mode::Bind ? mpolBind : mpolPreferred;
+            mask[policy.node / wordBits] |= 1ul << (policy.node % wordBits);
+            return true;
+    }
+}
+
+
+
+inline long pageBytes()
+{
+#if defined(__linux__)
+    static const long bytes = sysconf(_SC_PAGESIZE);
+    return bytes;
+#else
+    return 4096;
+#endif
+}
+
+} // namespace detail
+
+} // namespace numa
+//***************************************************************************//
+
+#endif // NUMA_HPP
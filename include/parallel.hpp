@@ -0,0 +1,146 @@
+﻿#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+
+// Параллельный режим заполнения и копирования больших буферов Vector: копирующий конструктор,
+// assign, resize и append. По умолчанию выключен. Буфер делится между потоками на части
+// по целым страницам, и каждую часть первым записывает свой поток - на NUMA-машине страницы
+// нового буфера распределяются по узлам этих потоков (first-touch), а не оседают на узле
+// вызывающего. Параллельно обрабатываются только тривиально копируемые элементы: их
+// копирование не бросает исключений, и откатывать частично заполненные части не нужно
+
+namespace parallel {
+
+// Включает параллельный режим для буферов от thresholdBytes байт (0 - выключает);
+// threads = 0 - по числу аппаратных потоков
+void enable(std::size_t thresholdBytes, unsigned threads = 0);
+
+// Выключает параллельный режим
+void disable();
+
+// Сколько потоков обработает буфер из bytes байт (1 - последовательно в вызывающем потоке)
+unsigned threadsFor(std::size_t bytes);
+
+// Вызывает function(first, last) для частей диапазона [0, count) элементов размера elementSize,
+// каждую - в своём потоке; текущий поток обрабатывает первую часть. Если поток не удалось
+// создать, его часть обрабатывается в текущем потоке. function не должна бросать исключений
+template<typename Function>
+void forEachChunk(std::size_t count, std::size_t elementSize, Function function);
+
+
+
+namespace detail {
+
+struct Settings
+{
+    std::atomic<std::size_t> thresholdBytes{0};
+    std::atomic<unsigned> threads{0};
+};
+
+Settings& settings();
+
+// Части кратны этому размеру, чтобы страница не делилась между потоками
+constexpr std::size_t pageSize = 4096;
+
+} // namespace detail
+
+} // namespace parallel
+
+
+
+//***************************************************************************//
+namespace parallel {
+
+namespace detail {
+
+inline Settings& settings()
+{
+    static Settings instance;
+    return instance;
+}
+
+} // namespace detail
+
+
+
+inline void enable(std::size_t thresholdBytes, unsigned threads)
+{
+    detail::settings().threads.store(threads, std::memory_order_relaxed);
+    detail::settings().thresholdBytes.store(thresholdBytes, std::memory_order_relaxed);
+}
+
+
+
+inline void disable()
+{
+    detail::settings().thresholdBytes.store(0, std::memory_order_relaxed);
+}
+
+
+
+inline unsigned threadsFor(std::size_t bytes)
+{
+    std::size_t threshold = detail::settings().thresholdBytes.load(std::memory_order_relaxed);
+    if (threshold == 0 || bytes < threshold) {
+        return 1;
+    }
+
+    unsigned threads = detail::settings().threads.load(std::memory_order_relaxed);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Не меньше страницы на поток
+    std::size_t pages = std::max<std::size_t>(1, bytes / detail::pageSize);
+    return static_cast<unsigned>(std::min<std::size_t>(threads, pages));
+}
+
+
+
+template<typename Function>
+void forEachChunk(std::size_t count, std::size_t elementSize, Function function)
+{
+    unsigned threads = threadsFor(count * elementSize);
+    if (threads <= 1) {
+        function(std::size_t(0), count);
+        return;
+    }
+
+    std::size_t granule = std::max<std::size_t>(1, detail::pageSize / elementSize);
+    std::size_t chunk = ((count + threads - 1) / threads + granule - 1) / granule * granule;
+
+    std::unique_ptr<std::thread[]> workers(new (std::nothrow) std::thread[threads - 1]);
+    if (!workers) {
+        function(std::size_t(0), count);
+        return;
+    }
+    for (unsigned i = 1; i < threads; ++i) {
+        std::size_t first = std::min(count, chunk * i);
+        std::size_t last = std::min(count, first + chunk);
+        if (first == last) {
+            break;
+        }
+        try {
+            workers[i - 1] = std::thread(function, first, last);
+        } catch (...) {
+            function(first, last);
+        }
+    }
+    function(std::size_t(0), std::min(count, chunk));
+
+    for (unsigned i = 0; i + 1 < threads; ++i) {
+        if (workers[i].joinable()) {
+            workers[i].join();
+        }
+    }
+}
+
+} // namespace parallel
+//***************************************************************************//
+
+#endif // PARALLEL_HPP
@@ -0,0 +1,604 @@
+﻿#ifndef STABLE_VECTOR_HPP
+#define STABLE_VECTOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+// Вектор из блоков фиксированного размера: элементы не переносятся при росте, поэтому
+// указатели и ссылки на них остаются действительными до удаления самих элементов (popBack,
+// clear). Блок вмещает 2^k элементов (наибольшая степень двойки, при которой блок не больше
+// ChunkBytes), индексация - сдвиг и маска плюс одно обращение к каталогу блоков. Рост
+// выделяет один новый блок и копирует только каталог - вектор указателей на блоки
+template<typename Type, std::size_t ChunkBytes = 64 * 1024, typename Allocator = std::allocator<Type>>
+class StableVector
+{
+    template<typename Value>
+    class Iterator;
+
+  public:
+
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+
+    // Итераторы произвольного доступа: индекс и указатель на вектор
+    using iterator = Iterator<Type>;
+    using const_iterator = Iterator<const Type>;
+
+    // Число элементов в блоке
+    static constexpr std::size_t chunkSize = [] {
+        std::size_t size = 1;
+        while (size * 2 * sizeof(Type) <= ChunkBytes) {
+            size *= 2;
+        }
+        return size;
+    }();
+
+    StableVector();
+
+    explicit StableVector(const Allocator& allocator);
+
+    StableVector(const StableVector& other);
+
+    // Копия other с памятью из allocator
+    StableVector(const StableVector& other, const Allocator& allocator);
+
+    StableVector& operator=(const StableVector& other);
+
+    StableVector(StableVector&& other) noexcept;
+
+    StableVector& operator=(StableVector&& other);
+
+    ~StableVector();
+
+    // Добавляет элемент в конец; существующие элементы не переносятся
+    void pushBack(const Type& element);
+
+    void pushBack(Type&& element);
+
+    // Конструирует элемент в конце вектора из args, возвращает ссылку на него
+    template <class ...Args>
+    Type& emplaceBack(Args&&... args);
+
+    // Удаляет последний элемент, бросает "LogicError" у пустого вектора
+    void popBack();
+
+    std::size_t size() const;
+
+    // Число элементов в выделенных блоках
+    std::size_t capacity() const;
+
+    bool empty() const;
+
+    // Выделяет блоки под как минимум count элементов
+    void reserve(std::size_t count);
+
+    // Уничтожает элементы и освобождает блоки
+    void clear();
+
+    // Возвращает ссылку на элемент в позиции index, бросает "IndexOutOfRange"
+    Type& at(std::size_t index);
+
+    const Type& at(std::size_t index) const;
+
+    Type& operator[](std::size_t index);
+
+    const Type& operator[](std::size_t index) const;
+
+    // Бросают "LogicError" у пустого вектора
+    Type& front();
+
+    const Type& front() const;
+
+    Type& back();
+
+    const Type& back() const;
+
+    iterator begin();
+
+    const_iterator begin() const;
+
+    iterator end();
+
+    const_iterator end() const;
+
+    // Число блоков и указатель на блок index - для обхода блоками без индексации каждого элемента
+    std::size_t chunkCount() const;
+
+    Type* chunk(std::size_t index);
+
+    const Type* chunk(std::size_t index) const;
+
+    // Возвращает копию используемого аллокатора
+    Allocator getAllocator() const;
+
+  private:
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    using DirectoryAllocator = typename AllocatorTraits::template rebind_alloc<Type*>;
+
+    static constexpr unsigned chunkShift = [] {
+        unsigned shift = 0;
+        while ((std::size_t(1) << shift) < chunkSize) {
+            ++shift;
+        }
+        return shift;
+    }();
+
+    // Обмен значениями (аллокаторами - только если этого требует propagate_on_container_swap)
+    void swap(StableVector& other);
+
+    // Возвращает память под элемент count_, при необходимости выделяя новый блок
+    Type* tail();
+
+    Allocator allocator_;
+
+    // Каталог блоков: при росте переаллоцируется он, а не элементы
+    Vector<Type*, DirectoryAllocator> chunks_;
+
+    std::size_t count_;
+};
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+template<typename Value>
+class StableVector<Type, ChunkBytes, Allocator>::Iterator
+{
+  public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<Value>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Value*;
+    using reference = Value&;
+
+    using Owner = std::conditional_t<std::is_const<Value>::value, const StableVector, StableVector>;
+
+    Iterator() : owner_(nullptr), index_(0) {}
+
+    Iterator(Owner* owner, std::size_t index) : owner_(owner), index_(index) {}
+
+    // Неконстантный итератор преобразуется в константный
+    template<typename Other, typename = std::enable_if_t<std::is_const<Value>::value && !std::is_const<Other>::value>>
+    Iterator(const Iterator<Other>& other) : owner_(other.owner_), index_(other.index_) {}
+
+    reference operator*() const { return (*owner_)[index_]; }
+
+    pointer operator->() const { return &(*owner_)[index_]; }
+
+    reference operator[](difference_type offset) const { return (*owner_)[index_ + offset]; }
+
+    Iterator& operator++() { ++index_; return *this; }
+
+    Iterator operator++(int) { Iterator old(*this); ++index_; return old; }
+
+    Iterator& operator--() { --index_; return *this; }
+
+    Iterator operator--(int) { Iterator old(*this); --index_; return old; }
+
+    Iterator& operator+=(difference_type offset) { index_ += offset; return *this; }
+
+    Iterator& operator-=(difference_type offset) { index_ -= offset; return *this; }
+
+    Iterator operator+(difference_type offset) const { return Iterator(owner_, index_ + offset); }
+
+    friend Iterator operator+(difference_type offset, const Iterator& it) { return it + offset; }
+
+    Iterator operator-(difference_type offset) const { return Iterator(owner_, index_ - offset); }
+
+    difference_type operator-(const Iterator& other) const
+    {
+        return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const Iterator& other) const { return index_ == other.index_; }
+
+    bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+    bool operator<(const Iterator& other) const { return index_ < other.index_; }
+
+    bool operator>(const Iterator& other) const { return index_ > other.index_; }
+
+    bool operator<=(const Iterator& other) const { return index_ <= other.index_; }
+
+    bool operator>=(const Iterator& other) const { return index_ >= other.index_; }
+
+  private:
+
+    template<typename Other>
+    friend class Iterator;
+
+    Owner* owner_;
+
+    std::size_t index_;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::StableVector()
+    : StableVector(Allocator())
+{
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::StableVector(const Allocator& allocator)
+    : allocator_(allocator), chunks_(DirectoryAllocator(allocator)), count_(0)
+{
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::StableVector(const StableVector& other)
+    : StableVector(other, AllocatorTraits::select_on_container_copy_construction(other.allocator_))
+{
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::StableVector(const StableVector& other, const Allocator& allocator)
+    : StableVector(allocator)
+{
+    try {
+        reserve(other.count_);
+        for (std::size_t i = 0; i < other.count_; ++i) {
+            pushBack(other[i]);
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>& StableVector<Type, ChunkBytes, Allocator>::operator=(const StableVector& other)
+{
+    if (this != &other) {
+        if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+            if (allocator_ != other.allocator_) {
+                clear();
+            }
+            allocator_ = other.allocator_;
+        }
+        StableVector tmp(other, allocator_);
+        swap(tmp);
+    }
+    return *this;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::StableVector(StableVector&& other) noexcept
+    : allocator_(std::move(other.allocator_)), chunks_(std::move(other.chunks_)), count_(other.count_)
+{
+    other.count_ = 0;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>& StableVector<Type, ChunkBytes, Allocator>::operator=(StableVector&& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+        clear();
+        allocator_ = other.allocator_;
+    } else if (allocator_ != other.allocator_) {
+        // Блоки other нельзя освободить нашим аллокатором - переносим поэлементно
+        StableVector tmp(allocator_);
+        tmp.reserve(other.count_);
+        for (std::size_t i = 0; i < other.count_; ++i) {
+            tmp.pushBack(std::move(other[i]));
+        }
+        other.clear();
+        swap(tmp);
+        return *this;
+    } else {
+        clear();
+    }
+    swap(other);
+    return *this;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+StableVector<Type, ChunkBytes, Allocator>::~StableVector()
+{
+    clear();
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::pushBack(const Type& element)
+{
+    emplaceBack(element);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::pushBack(Type&& element)
+{
+    emplaceBack(std::move(element));
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+template <class ...Args>
+Type& StableVector<Type, ChunkBytes, Allocator>::emplaceBack(Args&&... args)
+{
+    // Элементы не переносятся, поэтому args может ссылаться на элемент этого же вектора
+    Type* place = tail();
+    AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+    ++count_;
+    return *place;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::popBack()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    --count_;
+    AllocatorTraits::destroy(allocator_, &(*this)[count_]);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+std::size_t StableVector<Type, ChunkBytes, Allocator>::size() const
+{
+    return count_;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+std::size_t StableVector<Type, ChunkBytes, Allocator>::capacity() const
+{
+    return chunks_.size() * chunkSize;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+bool StableVector<Type, ChunkBytes, Allocator>::empty() const
+{
+    return count_ == 0;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::reserve(std::size_t count)
+{
+    if (count <= capacity()) {
+        return;
+    }
+    std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+    chunks_.reserve(chunks);
+    while (chunks_.size() < chunks) {
+        // Место в каталоге уже есть: pushBack указателя не бросает исключений
+        chunks_.pushBack(AllocatorTraits::allocate(allocator_, chunkSize));
+    }
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::clear()
+{
+    for (std::size_t i = 0; i < count_; ++i) {
+        AllocatorTraits::destroy(allocator_, &(*this)[i]);
+    }
+    count_ = 0;
+    for (Type* chunk : chunks_) {
+        AllocatorTraits::deallocate(allocator_, chunk, chunkSize);
+    }
+    chunks_.clear();
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type& StableVector<Type, ChunkBytes, Allocator>::at(std::size_t index)
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+    return (*this)[index];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+const Type& StableVector<Type, ChunkBytes, Allocator>::at(std::size_t index) const
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+    return (*this)[index];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type& StableVector<Type, ChunkBytes, Allocator>::operator[](std::size_t index)
+{
+    return chunks_[index >> chunkShift][index & (chunkSize - 1)];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+const Type& StableVector<Type, ChunkBytes, Allocator>::operator[](std::size_t index) const
+{
+    return chunks_[index >> chunkShift][index & (chunkSize - 1)];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type& StableVector<Type, ChunkBytes, Allocator>::front()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[0];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+const Type& StableVector<Type, ChunkBytes, Allocator>::front() const
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[0];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type& StableVector<Type, ChunkBytes, Allocator>::back()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[count_ - 1];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+const Type& StableVector<Type, ChunkBytes, Allocator>::back() const
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+    return (*this)[count_ - 1];
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+typename StableVector<Type, ChunkBytes, Allocator>::iterator StableVector<Type, ChunkBytes, Allocator>::begin()
+{
+    return iterator(this, 0);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+typename StableVector<Type, ChunkBytes, Allocator>::const_iterator StableVector<Type, ChunkBytes, Allocator>::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+typename StableVector<Type, ChunkBytes, Allocator>::iterator StableVector<Type, ChunkBytes, Allocator>::end()
+{
+    return iterator(this, count_);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+typename StableVector<Type, ChunkBytes, Allocator>::const_iterator StableVector<Type, ChunkBytes, Allocator>::end() const
+{
+    return const_iterator(this, count_);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+std::size_t StableVector<Type, ChunkBytes, Allocator>::chunkCount() const
+{
+    return chunks_.size();
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type* StableVector<Type, ChunkBytes, Allocator>::chunk(std::size_t index)
+{
+    return chunks_.at(index);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+const Type* StableVector<Type, ChunkBytes, Allocator>::chunk(std::size_t index) const
+{
+    return chunks_.at(index);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Allocator StableVector<Type, ChunkBytes, Allocator>::getAllocator() const
+{
+    return allocator_;
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+void StableVector<Type, ChunkBytes, Allocator>::swap(StableVector& other)
+{
+    if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+        std::swap(allocator_, other.allocator_);
+    }
+    std::swap(chunks_, other.chunks_);
+    std::swap(count_, other.count_);
+}
+
+
+
+template<typename Type, std::size_t ChunkBytes, typename Allocator>
+Type* StableVector<Type, ChunkBytes, Allocator>::tail()
+{
+    if (count_ == capacity()) {
+        Type* chunk = AllocatorTraits::allocate(allocator_, chunkSize);
+        try {
+            chunks_.pushBack(chunk);
+        } catch (...) {
+            AllocatorTraits::deallocate(allocator_, chunk, chunkSize);
+            throw;
+        }
+    }
+    return &(*this)[count_];
+}
+//***************************************************************************//
+
+#endif // STABLE_VECTOR_HPP
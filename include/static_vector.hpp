@@ -0,0 +1,555 @@
+﻿#ifndef STATIC_VECTOR_HPP
+#define STATIC_VECTOR_HPP
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Политики переполнения StaticVector. checked = false убирает проверку вместимости целиком
+
+// Бросает "LengthError", как Vector при исчерпании maxSize
+struct ThrowOnOverflow
+{
+    static constexpr bool checked = true;
+
+    static void overflow()
+    {
+        throw "LengthError";
+    }
+};
+
+// Завершает программу без раскрутки стека - для кода, собранного без исключений
+struct TerminateOnOverflow
+{
+    static constexpr bool checked = true;
+
+    [[noreturn]] static void overflow()
+    {
+        std::terminate();
+    }
+};
+
+// Не проверяет вместимость: переполнение - неопределённое поведение
+struct UncheckedOverflow
+{
+    static constexpr bool checked = false;
+
+    static void overflow()
+    {
+    }
+};
+
+
+
+// Тег конструктора StaticVector для константных выражений в C++17: там каждый элемент массива
+// должен быть проинициализирован, поэтому такой конструктор обнуляет всё хранилище. Начиная
+// с C++20 тег не нужен - обычный конструктор обнуляет массив только при константном вычислении
+struct ConstexprInit
+{
+};
+
+constexpr ConstexprInit constexprInit{};
+
+
+
+namespace detail
+{
+    // Хранилище StaticVector для тривиальных типов: обычный массив, копирование и уничтожение
+    // тривиальны, поэтому StaticVector остаётся литеральным типом. Во время выполнения массив
+    // не инициализируется (как память Vector после reserve); константное вычисление требует
+    // инициализации всех элементов, поэтому там он обнуляется
+    template<typename Type, std::size_t N, bool Trivial = std::is_trivial<Type>::value>
+    class StaticVectorStorage
+    {
+      protected:
+
+#if defined(__cpp_lib_is_constant_evaluated)
+        constexpr StaticVectorStorage()
+        {
+            if (std::is_constant_evaluated()) {
+                for (auto& element : elements_) {
+                    element = Type();
+                }
+            }
+        }
+#else
+        StaticVectorStorage() {}
+#endif
+
+        constexpr explicit StaticVectorStorage(ConstexprInit) : elements_() {}
+
+        constexpr Type* data() { return elements_; }
+
+        constexpr const Type* data() const { return elements_; }
+
+        template <class ...Args>
+        constexpr void construct(std::size_t index, Args&&... args)
+        {
+            elements_[index] = Type(std::forward<Args>(args)...);
+        }
+
+        constexpr void destroy(std::size_t) {}
+
+        Type elements_[N];
+
+        std::size_t count_ = 0;
+    };
+
+
+
+    // Хранилище для остальных типов: неинициализированный выровненный буфер,
+    // элементы создаются размещающим new и уничтожаются явно
+    template<typename Type, std::size_t N>
+    class StaticVectorStorage<Type, N, false>
+    {
+      protected:
+
+        StaticVectorStorage() = default;
+
+        explicit StaticVectorStorage(ConstexprInit) {}
+
+        StaticVectorStorage(const StaticVectorStorage& other)
+        {
+            constructFrom(other.data(), other.count_);
+        }
+
+        StaticVectorStorage(StaticVectorStorage&& other) noexcept(std::is_nothrow_move_constructible<Type>::value)
+        {
+            constructFrom(std::make_move_iterator(other.data()), other.count_);
+        }
+
+        StaticVectorStorage& operator=(const StaticVectorStorage& other)
+        {
+            if (this != &other) {
+                destroyAll();
+                constructFrom(other.data(), other.count_);
+            }
+            return *this;
+        }
+
+        StaticVectorStorage& operator=(StaticVectorStorage&& other)
+        {
+            if (this != &other) {
+                destroyAll();
+                constructFrom(std::make_move_iterator(other.data()), other.count_);
+            }
+            return *this;
+        }
+
+        ~StaticVectorStorage()
+        {
+            destroyAll();
+        }
+
+        Type* data() { return reinterpret_cast<Type*>(bytes_); }
+
+        const Type* data() const { return reinterpret_cast<const Type*>(bytes_); }
+
+        template <class ...Args>
+        void construct(std::size_t index, Args&&... args)
+        {
+            ::new (static_cast<void*>(data() + index)) Type(std::forward<Args>(args)...);
+        }
+
+        void destroy(std::size_t index)
+        {
+            data()[index].~Type();
+        }
+
+        // Создаёт count элементов из source в пустом хранилище; при исключении уничтожает созданные
+        template<typename Iterator>
+        void constructFrom(Iterator source, std::size_t count)
+        {
+            try {
+                for (; count_ < count; ++count_, ++source) {
+                    construct(count_, *source);
+                }
+            } catch (...) {
+                destroyAll();
+                throw;
+            }
+        }
+
+        void destroyAll()
+        {
+            while (count_ > 0) {
+                destroy(--count_);
+            }
+        }
+
+        alignas(Type) unsigned char bytes_[N * sizeof(Type)];
+
+        std::size_t count_ = 0;
+    };
+}
+
+
+
+// Вектор фиксированной вместимости N с интерфейсом Vector. Элементы лежат внутри объекта,
+// куча не используется никогда; выход за N обрабатывает OverflowPolicy.
+// Для тривиальных типов все операции constexpr (в C++17 вектор для константного вычисления
+// создаётся конструктором с тегом constexprInit)
+template<typename Type, std::size_t N, typename OverflowPolicy = ThrowOnOverflow>
+class StaticVector : private detail::StaticVectorStorage<Type, N>
+{
+  public:
+
+    using value_type = Type;
+    using size_type = std::size_t;
+    using iterator = Type*;
+    using const_iterator = const Type*;
+
+    // Стандартный конструктор: память элементов тривиальных типов не заполняется
+    constexpr StaticVector() = default;
+
+    // Конструктор для константных выражений C++17: обнуляет хранилище
+    constexpr explicit StaticVector(ConstexprInit init);
+
+    // Добавить копию элемента в конец вектора
+    constexpr void pushBack(const Type& element);
+
+    // Переместить элемент в конец вектора
+    constexpr void pushBack(Type&& element);
+
+    // Удалить элемент из конца вектора
+    constexpr void popBack();
+
+    // Проинициализировать первые count элементов значением value
+    constexpr void assign(std::size_t count, const Type& value);
+
+    // Вовзрат ссылки на последний элемент в векторе
+    constexpr const Type& back() const;
+
+    // Вовзрат ссылки на первый элемент в векторе
+    constexpr const Type& front() const;
+
+    // Вовзращает вместимость вектора (всегда N)
+    constexpr std::size_t capacity() const;
+
+    // Возвращает текущую заполненность вектора
+    constexpr std::size_t size() const;
+
+    // Возвращает максимальную возможную заполненность вектора (всегда N)
+    constexpr std::size_t maxSize() const;
+
+    // Вовзращает true, если вектор пустой, иначе - false
+    constexpr bool empty() const;
+
+    // Удаляет все элементы
+    constexpr void clear();
+
+    // Проверяет, что size элементов помещаются в вектор
+    constexpr void reserve(std::size_t size);
+
+    // Создаёт в векторе count элементов и инициализирует их стандартными значениями
+    constexpr void resize(std::size_t count);
+
+    // Ничего не делает: память встроена в объект
+    constexpr void shrinkToFit();
+
+    // Возвращает ссылку на элемент в позиции index
+    constexpr Type& at(std::size_t index);
+
+    // Возвращает константную ссылку на элемент в позиции index
+    constexpr const Type& at(std::size_t index) const;
+
+    // Вовзращает ссылку на элемент в позиции index
+    constexpr Type& operator[](std::size_t index);
+
+    // Возвращает константную ссылку на элемент в позиции index
+    constexpr const Type& operator[](std::size_t index) const;
+
+    // Возвращает указатель на первый элемент
+    constexpr Type* data();
+
+    // Возвращает константный указатель на первый элемент
+    constexpr const Type* data() const;
+
+    // Итератор на первый элемент
+    constexpr iterator begin();
+
+    // Константный итератор на первый элемент
+    constexpr const_iterator begin() const;
+
+    // Итератор за последним элементом
+    constexpr iterator end();
+
+    // Константный итератор за последним элементом
+    constexpr const_iterator end() const;
+
+    // Конструирует элемент в конце вектора прямо в его памяти из args,
+    // возвращает ссылку на созданный элемент
+    template <class ...Args>
+    constexpr Type& emplaceBack(Args&&... args);
+
+  private:
+
+    using Storage = detail::StaticVectorStorage<Type, N>;
+
+    using Storage::construct;
+    using Storage::destroy;
+    using Storage::count_;
+
+    // Сообщает о переполнении, если count элементов не помещаются
+    constexpr void checkCapacity(std::size_t count) const;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr StaticVector<Type, N, OverflowPolicy>::StaticVector(ConstexprInit init)
+    : detail::StaticVectorStorage<Type, N>(init)
+{
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::pushBack(const Type& element)
+{
+    emplaceBack(element);
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::pushBack(Type&& element)
+{
+    emplaceBack(std::move(element));
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::popBack()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+
+    destroy(--count_);
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::assign(std::size_t count, const Type& value)
+{
+    checkCapacity(count);
+    std::size_t assigned = count < count_ ? count : count_;
+    for (std::size_t i = 0; i < assigned; i++) {
+        data()[i] = value;
+    }
+    for (; count_ < count; ++count_) {
+        construct(count_, value);
+    }
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr const Type& StaticVector<Type, N, OverflowPolicy>::back() const
+{
+    if(count_ > 0) {
+        return data()[count_ - 1];
+    }
+    throw "LogicError";
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr const Type& StaticVector<Type, N, OverflowPolicy>::front() const
+{
+    if(count_ > 0) {
+        return data()[0];
+    }
+    throw "LogicError";
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr std::size_t StaticVector<Type, N, OverflowPolicy>::capacity() const
+{
+    return N;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr std::size_t StaticVector<Type, N, OverflowPolicy>::size() const
+{
+    return count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr std::size_t StaticVector<Type, N, OverflowPolicy>::maxSize() const
+{
+    return N;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr bool StaticVector<Type, N, OverflowPolicy>::empty() const
+{
+    return count_ == 0;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::clear()
+{
+    while (count_ > 0) {
+        destroy(--count_);
+    }
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::reserve(std::size_t size)
+{
+    checkCapacity(size);
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::resize(std::size_t count)
+{
+    checkCapacity(count);
+    while (count_ > count) {
+        destroy(--count_);
+    }
+    for (; count_ < count; ++count_) {
+        construct(count_);
+    }
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::shrinkToFit()
+{
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr Type& StaticVector<Type, N, OverflowPolicy>::at(std::size_t index)
+{
+    if (index < count_) {
+        return data()[index];
+    }
+    throw "IndexOutOfRange";
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr const Type& StaticVector<Type, N, OverflowPolicy>::at(std::size_t index) const
+{
+    if (index < count_) {
+        return data()[index];
+    }
+    throw "IndexOutOfRange";
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr Type& StaticVector<Type, N, OverflowPolicy>::operator[](std::size_t index)
+{
+    return data()[index];
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr const Type& StaticVector<Type, N, OverflowPolicy>::operator[](std::size_t index) const
+{
+    return data()[index];
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr Type* StaticVector<Type, N, OverflowPolicy>::data()
+{
+    return Storage::data();
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr const Type* StaticVector<Type, N, OverflowPolicy>::data() const
+{
+    return Storage::data();
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<Type, N, OverflowPolicy>::iterator StaticVector<Type, N, OverflowPolicy>::begin()
+{
+    return data();
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<Type, N, OverflowPolicy>::const_iterator StaticVector<Type, N, OverflowPolicy>::begin() const
+{
+    return data();
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<Type, N, OverflowPolicy>::iterator StaticVector<Type, N, OverflowPolicy>::end()
+{
+    return data() + count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr typename StaticVector<Type, N, OverflowPolicy>::const_iterator StaticVector<Type, N, OverflowPolicy>::end() const
+{
+    return data() + count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+template <class ...Args>
+constexpr Type& StaticVector<Type, N, OverflowPolicy>::emplaceBack(Args&&... args)
+{
+    checkCapacity(count_ + 1);
+    construct(count_, std::forward<Args>(args)...);
+    return data()[count_++];
+}
+
+
+
+template<typename Type, std::size_t N, typename OverflowPolicy>
+constexpr void StaticVector<Type, N, OverflowPolicy>::checkCapacity(std::size_t count) const
+{
+    if constexpr (OverflowPolicy::checked) {
+        if (count > N) {
+            OverflowPolicy::overflow();
+        }
+    }
+}
+//***************************************************************************//
+
+#endif // STATIC_VECTOR_HPP
@@ -0,0 +1,255 @@
+﻿#ifndef THREAD_LOCAL_VECTOR_HPP
+#define THREAD_LOCAL_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "vector.hpp"
+#include "vector_kernels.hpp"
+
+// Набор векторов по одному на поток для параллельных циклов: local() возвращает вектор
+// вызывающего потока, в который он добавляет элементы без синхронизации, combine() склеивает
+// все части в один Vector. Части выровнены по кэш-линии: заголовки векторов (указатель,
+// размер, вместимость), которые меняет каждое добавление, у разных потоков не делят линию.
+//
+// Первый вызов local() в потоке регистрирует его часть под мьютексом, следующие находят её
+// в thread_local-кэше без блокировок (кэш помнит последний ThreadLocalVector, с которым
+// работал поток). shard(), combine() и clear() вызываются, когда параллельная запись окончена
+template<typename Type, typename Allocator = std::allocator<Type>>
+class ThreadLocalVector
+{
+  public:
+
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using VectorType = Vector<Type, Allocator>;
+
+    ThreadLocalVector();
+
+    explicit ThreadLocalVector(const Allocator& allocator);
+
+    ThreadLocalVector(const ThreadLocalVector&) = delete;
+
+    ThreadLocalVector& operator=(const ThreadLocalVector&) = delete;
+
+    // Вектор вызывающего потока (создаётся при первом обращении потока)
+    VectorType& local();
+
+    // Число частей (потоков, обращавшихся к local())
+    std::size_t shardCount() const;
+
+    // Часть с номером index в порядке регистрации потоков
+    VectorType& shard(std::size_t index);
+
+    const VectorType& shard(std::size_t index) const;
+
+    // Суммарное число элементов во всех частях
+    std::size_t size() const;
+
+    // Склеивает части в порядке регистрации. Начало каждой части в результате - префиксная
+    // сумма размеров предыдущих; тривиально копируемые элементы копируются memcpy по частям
+    // результата в нескольких потоках (parallel::forEachChunk, если включён parallel::enable)
+    VectorType combine() const;
+
+    // Очищает все части, сохраняя их память и привязку к потокам
+    void clear();
+
+  private:
+
+    struct alignas(64) Shard
+    {
+        explicit Shard(const Allocator& allocator);
+
+        std::thread::id owner;
+        VectorType elements;
+    };
+
+    // Последняя часть, полученная потоком через local(), и номер её ThreadLocalVector
+    struct LocalCache
+    {
+        std::uint64_t owner;
+        Shard* shard;
+    };
+
+    static LocalCache& localCache();
+
+    // Номера экземпляров не повторяются, поэтому кэш не спутает новый экземпляр со старым
+    // по совпавшему адресу
+    static std::uint64_t nextId();
+
+    Allocator allocator_;
+
+    std::uint64_t id_;
+
+    // Защищает shards_ при регистрации потоков
+    std::mutex mutex_;
+
+    // Части живут в отдельных блоках: переаллокация shards_ не двигает их
+    Vector<std::unique_ptr<Shard>> shards_;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, typename Allocator>
+ThreadLocalVector<Type, Allocator>::Shard::Shard(const Allocator& allocator)
+    : owner(std::this_thread::get_id()), elements(allocator)
+{
+}
+
+
+
+template<typename Type, typename Allocator>
+ThreadLocalVector<Type, Allocator>::ThreadLocalVector()
+    : ThreadLocalVector(Allocator())
+{
+}
+
+
+
+template<typename Type, typename Allocator>
+ThreadLocalVector<Type, Allocator>::ThreadLocalVector(const Allocator& allocator)
+    : allocator_(allocator), id_(nextId())
+{
+}
+
+
+
+template<typename Type, typename Allocator>
+typename ThreadLocalVector<Type, Allocator>::VectorType& ThreadLocalVector<Type, Allocator>::local()
+{
+    LocalCache& cache = localCache();
+    if (cache.owner == id_) {
+        return cache.shard->elements;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::thread::id self = std::this_thread::get_id();
+    auto found = std::find_if(shards_.begin(), shards_.end(),
+                              [self](const std::unique_ptr<Shard>& shard) { return shard->owner == self; });
+    Shard* shard = nullptr;
+    if (found != shards_.end()) {
+        shard = found->get();
+    } else {
+        shards_.pushBack(std::unique_ptr<Shard>(new Shard(allocator_)));
+        shard = shards_.back().get();
+    }
+    cache.owner = id_;
+    cache.shard = shard;
+    return shard->elements;
+}
+
+
+
+template<typename Type, typename Allocator>
+std::size_t ThreadLocalVector<Type, Allocator>::shardCount() const
+{
+    return shards_.size();
+}
+
+
+
+template<typename Type, typename Allocator>
+typename ThreadLocalVector<Type, Allocator>::VectorType& ThreadLocalVector<Type, Allocator>::shard(std::size_t index)
+{
+    return shards_.at(index)->elements;
+}
+
+
+
+template<typename Type, typename Allocator>
+const typename ThreadLocalVector<Type, Allocator>::VectorType&
+ThreadLocalVector<Type, Allocator>::shard(std::size_t index) const
+{
+    return shards_.at(index)->elements;
+}
+
+
+
+template<typename Type, typename Allocator>
+std::size_t ThreadLocalVector<Type, Allocator>::size() const
+{
+    std::size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->elements.size();
+    }
+    return total;
+}
+
+
+
+template<typename Type, typename Allocator>
+typename ThreadLocalVector<Type, Allocator>::VectorType ThreadLocalVector<Type, Allocator>::combine() const
+{
+    // offsets[i] - начало части i в результате, offsets[shardCount()] - общий размер
+    Vector<std::size_t> offsets;
+    offsets.resize(shards_.size() + 1);
+    for (std::size_t i = 0; i < shards_.size(); ++i) {
+        offsets[i + 1] = shards_[i]->elements.size();
+    }
+    kernels::prefixSum(offsets);
+    std::size_t total = offsets.back();
+
+    VectorType result(allocator_);
+    result.reserve(total);
+    if constexpr (std::is_trivially_copyable<Type>::value) {
+        Type* destination = result.data();
+        parallel::forEachChunk(total, sizeof(Type), [&](std::size_t first, std::size_t last) {
+            // Первая часть, пересекающаяся с [first, last)
+            std::size_t index = std::upper_bound(offsets.begin(), offsets.end(), first) - offsets.begin() - 1;
+            for (; first < last; ++index) {
+                std::size_t end = std::min(last, offsets[index + 1]);
+                if (end > first) {
+                    std::memcpy(static_cast<void*>(destination + first),
+                                static_cast<const void*>(shards_[index]->elements.data() + (first - offsets[index])),
+                                (end - first) * sizeof(Type));
+                    first = end;
+                }
+            }
+        });
+        result.commitOverwritten(total);
+    } else {
+        for (const auto& shard : shards_) {
+            result.append(shard->elements.begin(), shard->elements.end());
+        }
+    }
+    return result;
+}
+
+
+
+template<typename Type, typename Allocator>
+void ThreadLocalVector<Type, Allocator>::clear()
+{
+    for (auto& shard : shards_) {
+        shard->elements.erase(0, shard->elements.size());
+    }
+}
+
+
+
+template<typename Type, typename Allocator>
+typename ThreadLocalVector<Type, Allocator>::LocalCache& ThreadLocalVector<Type, Allocator>::localCache()
+{
+    thread_local LocalCache cache{0, nullptr};
+    return cache;
+}
+
+
+
+template<typename Type, typename Allocator>
+std::uint64_t ThreadLocalVector<Type, Allocator>::nextId()
+{
+    static std::atomic<std::uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+//***************************************************************************//
+
+#endif // THREAD_LOCAL_VECTOR_HPP
@@ -2,35 +2,1389 @@
 #define VECTOR_HPP
 
 #include <algorithm>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "allocators.hpp"
+#include "growth_policy.hpp"
+#include "parallel.hpp"
+#include "vector_kernels.hpp"
+
+// Признак типа, объекты которого можно перенести в другую память побитовым копированием,
+// не вызывая конструктор перемещения и деструктор исходного объекта.
+// Можно специализировать для собственных типов (дескрипторы, умные указатели и т.п.)
+template<typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type>
+{
+};
+
+template<typename Type>
+struct IsTriviallyRelocatable<std::unique_ptr<Type>> : std::true_type
+{
+};
+
+template<typename Type>
+struct IsTriviallyRelocatable<std::shared_ptr<Type>> : std::true_type
+{
+};
+
+template<typename Type>
+constexpr bool isTriviallyRelocatable = IsTriviallyRelocatable<Type>::value;
+
+// Признак ленивого поэлементного выражения над векторами (vector_expressions.hpp): Vector
+// вычисляет его при конструировании и присваивании. Выражение предоставляет size() и operator[]
+template<typename Type>
+struct IsVectorExpression : std::false_type
+{
+};
+
+
+
+namespace detail
+{
+    // true, если у аллокатора есть reallocate(data, oldCount, newCount) - перенос буфера
+    // с побитовым копированием содержимого (realloc, mremap)
+    template<typename Allocator, typename = void>
+    struct HasReallocate : std::false_type
+    {
+    };
+
+    template<typename Allocator>
+    struct HasReallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+        std::declval<typename Allocator::value_type*>(), std::size_t(), std::size_t()))>> : std::true_type
+    {
+    };
+
+    // true, если у аллокатора есть allocateZeroed(count) - выделение уже обнулённой памяти
+    // (calloc, анонимный mmap), страницы которой ядро выдаёт лениво при первом обращении
+    template<typename Allocator, typename = void>
+    struct HasAllocateZeroed : std::false_type
+    {
+    };
+
+    template<typename Allocator>
+    struct HasAllocateZeroed<Allocator, std::void_t<decltype(std::declval<Allocator&>().allocateZeroed(
+        std::size_t()))>> : std::true_type
+    {
+    };
+
+    // true, если все байты value нулевые
+    template<typename Type>
+    bool isZeroBytes(const Type& value)
+    {
+        static_assert(std::is_trivially_copyable<Type>::value, "isZeroBytes requires trivially copyable type");
+
+        unsigned char bytes[sizeof(Type)];
+        std::memcpy(bytes, &value, sizeof(Type));
+        return std::all_of(bytes, bytes + sizeof(Type), [](unsigned char byte) { return byte == 0; });
+    }
+
+    // true, если у аллокатора есть expand(data, oldCount, newCount) - изменение размера блока на месте
+    template<typename Allocator, typename = void>
+    struct HasExpand : std::false_type
+    {
+    };
+
+    template<typename Allocator>
+    struct HasExpand<Allocator, std::void_t<decltype(std::declval<Allocator&>().expand(
+        std::declval<typename Allocator::value_type*>(), std::size_t(), std::size_t()))>> : std::true_type
+    {
+    };
+
+    // Пытается изменить размер блока data с oldCount до newCount элементов без переноса:
+    // через expand аллокатора или, для polymorphic_allocator, через MonotonicArena::expand
+    template<typename Allocator, typename Type>
+    bool tryExpand(Allocator& allocator, Type* data, std::size_t oldCount, std::size_t newCount)
+    {
+        if constexpr (HasExpand<Allocator>::value) {
+            return allocator.expand(data, oldCount, newCount);
+        } else if constexpr (std::is_same<Allocator, std::pmr::polymorphic_allocator<Type>>::value) {
+            auto* arena = dynamic_cast<MonotonicArena*>(allocator.resource());
+            return arena != nullptr && newCount <= std::size_t(-1) / sizeof(Type)
+                   && arena->expand(data, oldCount * sizeof(Type), newCount * sizeof(Type));
+        } else {
+            (void)allocator;
+            (void)data;
+            (void)oldCount;
+            (void)newCount;
+            return false;
+        }
+    }
+
+    // Переносит count элементов из source в неинициализированную память destination
+    // и уничтожает исходные объекты. Тривиально переносимые типы копируются одним memcpy,
+    // остальные перемещаются, если перемещение не бросает, иначе копируются: при исключении
+    // созданные в destination объекты уничтожаются, а source остаётся нетронутым
+    template<typename Allocator, typename Type>
+    void relocate(Allocator& allocator, Type* source, std::size_t count, Type* destination)
+    {
+        using AllocatorTraits = std::allocator_traits<Allocator>;
+
+        if constexpr (isTriviallyRelocatable<Type>) {
+            if (count > 0) {
+                std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(Type));
+            }
+        } else {
+            std::size_t constructed = 0;
+            try {
+                for (; constructed < count; ++constructed) {
+                    AllocatorTraits::construct(allocator, destination + constructed,
+                                               std::move_if_noexcept(source[constructed]));
+                }
+            } catch (...) {
+                while (constructed > 0) {
+                    AllocatorTraits::destroy(allocator, destination + --constructed);
+                }
+                throw;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                AllocatorTraits::destroy(allocator, source + i);
+            }
+        }
+    }
+
+    // Копирует count элементов из source в неинициализированную память destination.
+    // Тривиально копируемые типы копируются memcpy (большие буферы - по частям в нескольких
+    // потоках, если включён parallel::enable); при исключении уже созданные копии уничтожаются
+    template<typename Allocator, typename Type>
+    void uninitializedCopy(Allocator& allocator, const Type* source, std::size_t count, Type* destination)
+    {
+        using AllocatorTraits = std::allocator_traits<Allocator>;
+
+        if constexpr (std::is_trivially_copyable<Type>::value) {
+            if (count > 0) {
+                parallel::forEachChunk(count, sizeof(Type), [source, destination](std::size_t first, std::size_t last) {
+                    std::memcpy(static_cast<void*>(destination + first), static_cast<const void*>(source + first),
+                                (last - first) * sizeof(Type));
+                });
+            }
+        } else {
+            std::size_t constructed = 0;
+            try {
+                for (; constructed < count; ++constructed) {
+                    AllocatorTraits::construct(allocator, destination + constructed, source[constructed]);
+                }
+            } catch (...) {
+                while (constructed > 0) {
+                    AllocatorTraits::destroy(allocator, destination + --constructed);
+                }
+                throw;
+            }
+        }
+    }
+
+    // Заполняет count элементов по адресу data значением value (память уже инициализирована
+    // или Type тривиально копируемый). Для однобайтовых и нулевых значений сводится к memset,
+    // арифметические типы заполняются векторным ядром под набор инструкций процессора.
+    // Большие буферы заполняются по частям в нескольких потоках, если включён parallel::enable
+    template<typename Type>
+    void fillTrivial(Type* data, std::size_t count, const Type& value)
+    {
+        static_assert(std::is_trivially_copyable<Type>::value, "fillTrivial requires trivially copyable type");
+
+        if (count == 0) {
+            return;
+        }
+
+        unsigned char bytes[sizeof(Type)];
+        std::memcpy(bytes, &value, sizeof(Type));
+        bool sameBytes = std::all_of(bytes, bytes + sizeof(Type),
+                                     [&bytes](unsigned char byte) { return byte == bytes[0]; });
+        parallel::forEachChunk(count, sizeof(Type), [&](std::size_t first, std::size_t last) {
+            if (sameBytes) {
+                std::memset(static_cast<void*>(data + first), bytes[0], (last - first) * sizeof(Type));
+            } else if constexpr (kernels::detail::simdElement<Type>) {
+                kernels::fill(data + first, last - first, value);
+            } else {
+                std::fill_n(data + first, last - first, value);
+            }
+        });
+    }
+}
+
+
+
+template<typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class Vector
+{
+  public:
+
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+
+    // Итераторы - обычные указатели: Vector - непрерывный диапазон (contiguous_range в C++20),
+    // и стандартные алгоритмы работают с его памятью напрямую
+    using iterator = Type*;
+    using const_iterator = const Type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Стандартный конструктор
+    Vector();
+
+    // Конструктор с заданным аллокатором
+    explicit Vector(const Allocator& allocator);
+
+    // Конструктор из списка инициализации (память выделяется ровно под list.size() элементов)
+    Vector(std::initializer_list<Type> list, const Allocator& allocator = Allocator());
+
+    // Конструктор из поэлементного выражения: элементы вычисляются за один проход,
+    // без промежуточных векторов. Только для арифметических Type
+    template<typename Expression, typename = std::enable_if_t<IsVectorExpression<Expression>::value>>
+    Vector(const Expression& expression, const Allocator& allocator = Allocator());
+
+    // Конструктор копирования
+    Vector(const Vector& other);
+
+    // Конструктор копирования с заданным аллокатором
+    Vector(const Vector& other, const Allocator& allocator);
+
+    // Оператор копирующего присваивания
+    Vector& operator=(const Vector& other);
+
+    // Присваивание поэлементного выражения; сам вектор может входить в выражение
+    template<typename Expression, typename = std::enable_if_t<IsVectorExpression<Expression>::value>>
+    Vector& operator=(const Expression& expression);
+
+    // Конструктор перемещения; noexcept, чтобы вложенные векторы переносились при росте без копирования
+    Vector(Vector&& other) noexcept;
+
+    // Оператор присваивания перемещением; бросает только при разных непереносимых аллокаторах
+    Vector& operator=(Vector&& other) noexcept(AllocatorTraits::propagate_on_container_move_assignment::value
+                                               || AllocatorTraits::is_always_equal::value);
+
+    // Деструктор
+    ~Vector();
+
+    // Добавить копию элемента в конец вектора
+    void pushBack(const Type& element);
+
+    // Переместить элемент в конец вектора
+    void pushBack(Type&& element);
+
+    // Добавить в конец вектора элементы диапазона [first, last). Для прямых итераторов
+    // память расширяется один раз, тривиально копируемые элементы копируются одним memcpy
+    template<typename Iterator>
+    void append(Iterator first, Iterator last);
+
+    // Добавить в конец вектора count элементов, начиная с data (data может указывать внутрь вектора)
+    void append(const Type* data, std::size_t count);
+
+    // Вставить элементы диапазона [first, last) перед позицией index.
+    // Диапазон не должен указывать внутрь самого вектора
+    template<typename Iterator>
+    void insert(std::size_t index, Iterator first, Iterator last);
+
+    // Вставить копию элемента перед позицией index
+    void insert(std::size_t index, const Type& element);
+
+    // Вставить элемент перемещением перед позицией index
+    void insert(std::size_t index, Type&& element);
+
+    // Конструирует элемент из args перед позицией index, возвращает ссылку на него.
+    // Тривиально переносимые элементы сдвигаются одним memmove
+    template <class ...Args>
+    Type& emplace(std::size_t index, Args&&... args);
+
+    // Удалить элемент в позиции index, сдвинув хвост
+    void erase(std::size_t index);
+
+    // Удалить элементы в позициях [first, last), сдвинув хвост
+    void erase(std::size_t first, std::size_t last);
+
+    // Удалить элемент в позиции index за O(1), переместив на его место последний элемент
+    // (порядок элементов не сохраняется)
+    void eraseUnordered(std::size_t index);
+
+    // Удалить элемент из конца вектора
+    void popBack();
+
+    // Проинициализировать первые count элементов значением value
+    void assign(std::size_t count, const Type& value);
+
+    // Вовзрат ссылки на последний элемент в векторе
+    const Type& back() const;
+
+    // Вовзрат ссылки на первый элемент в векторе
+    const Type& front() const;
+
+    // Вовзращает текущую вместимость вектора
+    std::size_t capacity() const;
+
+    // Возвращает текущую заполненность вектора
+    std::size_t size() const;
+
+    // Возвращает максимальную возможную заполненность вектора
+    std::size_t maxSize() const;
+
+    // Вовзращает true, если вектор пустой, иначе - false
+    bool empty() const;
+
+    // Очищает вектор
+    void clear();
+
+    // Выделяет память для хранения как минимум size элементов типа Type, не инициализируя
+    void reserve(std::size_t size);
+
+    // Создаёт в векторе count элементов и инициализирует их стандартными значениями
+    void resize(std::size_t count);
+
+    // Как resize, но новые элементы инициализируются по умолчанию (Type, а не Type()):
+    // у тривиальных типов их значения не определены и память не заполняется
+    void resizeDefaultInit(std::size_t count);
+
+    // Увеличивает размер на count неинициализированных элементов и возвращает указатель на
+    // первый из них, чтобы записать их напрямую (read, memcpy). Только для тривиальных типов
+    Type* growForOverwrite(std::size_t count);
+
+    // Увеличивает размер на count элементов, уже записанных в резерв за size() (в пределах
+    // capacity()), например, потоками через ClaimWriter. Только для тривиально копируемых и
+    // тривиально уничтожаемых типов
+    void commitOverwritten(std::size_t count);
+
+    // Если неиспользуемой памяти слишком много, то сокращает её размер по правилу GrowthPolicy
+    // (для DoublingGrowth - до 2^round(log2(count_)))
+    void shrinkToFit();
+
+    // Возвращает ссылку на элемент в позиции index
+    Type& at(std::size_t index);
+
+    // Возвращает константную ссылку на элемент в позиции index
+    const Type& at(std::size_t index) const;
+
+    // Вовзращает ссылку на элемент в позиции index
+    Type& operator[](std::size_t index);
+
+    // Возвращает константную ссылку на элемент в позиции index
+    const Type& operator[](std::size_t index) const;
+
+    // Возвращает указатель на первый элемент (nullptr у вектора без памяти)
+    Type* data();
+
+    // Возвращает константный указатель на первый элемент
+    const Type* data() const;
+
+    // Итератор на первый элемент
+    iterator begin();
+
+    // Константный итератор на первый элемент
+    const_iterator begin() const;
+
+    // Константный итератор на первый элемент
+    const_iterator cbegin() const;
+
+    // Итератор за последним элементом
+    iterator end();
+
+    // Константный итератор за последним элементом
+    const_iterator end() const;
+
+    // Константный итератор за последним элементом
+    const_iterator cend() const;
+
+    // Обратный итератор на последний элемент
+    reverse_iterator rbegin();
+
+    // Константный обратный итератор на последний элемент
+    const_reverse_iterator rbegin() const;
+
+    // Обратный итератор перед первым элементом
+    reverse_iterator rend();
+
+    // Константный обратный итератор перед первым элементом
+    const_reverse_iterator rend() const;
+
+    // Возвращает копию используемого аллокатора
+    Allocator getAllocator() const;
+
+    // Конструирует элемент в конце вектора прямо в его памяти из args,
+    // возвращает ссылку на созданный элемент
+    template <class ...Args>
+    Type& emplaceBack(Args&&... args);
+
+    // Переносит уже выделенные страницы буфера на узел NUMA node (move_pages). Буферы после
+    // переаллокации размещаются по политике аллокатора (NumaAllocator). Возвращает false,
+    // если перенести страницы нельзя: нет такого узла, ядро без NUMA, вызов запрещён
+    bool migrate(int node);
+
+  private:
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    // Обмен значениями (аллокаторами - только если этого требует propagate_on_container_swap)
+    void swap(Vector& other);
+
+    // Переносит элементы в новый буфер вместимостью newCapacity (строгая гарантия исключений)
+    void reallocate(std::size_t newCapacity);
+
+    // Вызывает деструкторы элементов в позициях [first, count_) и уменьшает count_
+    void destroyTail(std::size_t first);
+
+    // Записывает в вектор значения поэлементного выражения
+    template<typename Expression>
+    void evaluate(const Expression& expression);
+
+    // Переходит на новый буфер, обнулённый аллокатором, переносит в него первые keep элементов
+    // и делает размер равным count: остальные элементы - нули, которые не нужно записывать
+    void reallocateZeroed(std::size_t count, std::size_t keep);
+
+    // Можно ли получать нулевые элементы от allocateZeroed: у скалярных типов (кроме указателей
+    // на члены) значение Type() состоит из нулевых байт
+    static constexpr bool lazyZero = detail::HasAllocateZeroed<Allocator>::value
+                                     && std::is_scalar<Type>::value && !std::is_member_pointer<Type>::value;
+
+    // Аллокатор, из которого берётся память под элементы
+    Allocator allocator_;
+
+    // Указатель на неинициализированную память под элементы
+    Type* data_;
+
+    // Заполненость (количество сконструированных элементов)
+    std::size_t count_;
+
+    // Вместимость
+    std::size_t capacity_;
+};
+
+
+
+//***************************************************************************//
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector()
+    : Vector(Allocator())
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector(const Allocator& allocator)
+    : allocator_{allocator}, data_{nullptr}, count_{0}, capacity_{0}
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector(std::initializer_list<Type> list, const Allocator& allocator)
+    : Vector(allocator)
+{
+    if (list.size() > 0) {
+        reallocate(list.size());
+        append(list.begin(), list.size());
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template<typename Expression, typename>
+Vector<Type, Allocator, GrowthPolicy>::Vector(const Expression& expression, const Allocator& allocator)
+    : Vector(allocator)
+{
+    evaluate(expression);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector(const Vector& other)
+    : Vector(other, AllocatorTraits::select_on_container_copy_construction(other.allocator_))
+{
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector(const Vector& other, const Allocator& allocator)
+    : Vector(allocator)
+{
+    if (other.capacity_ == 0) {
+        return;
+    }
+
+    data_ = AllocatorTraits::allocate(allocator_, other.capacity_);
+    capacity_ = other.capacity_;
+    try {
+        detail::uninitializedCopy(allocator_, other.data_, other.count_, data_);
+    } catch (...) {
+        clear();
+        throw;
+    }
+    count_ = other.count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template<typename Expression, typename>
+Vector<Type, Allocator, GrowthPolicy>& Vector<Type, Allocator, GrowthPolicy>::operator=(const Expression& expression)
+{
+    evaluate(expression);
+    return *this;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::Vector(Vector&& other) noexcept
+    : Vector(other.allocator_)
+{
+    swap(other);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>& Vector<Type, Allocator, GrowthPolicy>::operator=(const Vector& other)
+{
+    if (this != &other) {
+        if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+            if (allocator_ != other.allocator_) {
+                clear();
+            }
+            allocator_ = other.allocator_;
+        }
+        Vector tmp(other, allocator_);
+        tmp.swap(*this);
+    }
+    return *this;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>& Vector<Type, Allocator, GrowthPolicy>::operator=(Vector&& other)
+    noexcept(AllocatorTraits::propagate_on_container_move_assignment::value || AllocatorTraits::is_always_equal::value)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+        clear();
+        allocator_ = other.allocator_;
+    } else if (allocator_ != other.allocator_) {
+        // Память other нельзя освободить нашим аллокатором (например, другая арена) - переносим поэлементно
+        Vector tmp(allocator_);
+        tmp.reserve(other.count_);
+        detail::relocate(tmp.allocator_, other.data_, other.count_, tmp.data_);
+        tmp.count_ = other.count_;
+        other.count_ = 0;
+        other.clear();
+        tmp.swap(*this);
+        return *this;
+    } else {
+        clear();
+    }
+    swap(other);
+    return *this;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Vector<Type, Allocator, GrowthPolicy>::~Vector()
+{
+    clear();
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::reserve(std::size_t size)
+{
+    if (size <= capacity_) {
+        return;
+    }
+
+    reallocate(GrowthPolicy::grow(capacity_, size, maxSize(), sizeof(Type)));
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::pushBack(const Type& element)
+{
+    emplaceBack(element);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::pushBack(Type&& element)
+{
+    emplaceBack(std::move(element));
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template<typename Iterator>
+void Vector<Type, Allocator, GrowthPolicy>::append(Iterator first, Iterator last)
+{
+    using Category = typename std::iterator_traits<Iterator>::iterator_category;
+
+    if constexpr (std::is_pointer<Iterator>::value
+                  && std::is_same<std::remove_cv_t<std::remove_pointer_t<Iterator>>, Type>::value) {
+        append(first, static_cast<std::size_t>(last - first));
+    } else if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        if (count > maxSize() - count_) {
+            throw "LengthError";
+        }
+        reserve(count_ + count);
+
+        std::size_t oldCount = count_;
+        try {
+            for (; first != last; ++first, ++count_) {
+                AllocatorTraits::construct(allocator_, data_ + count_, *first);
+            }
+        } catch (...) {
+            destroyTail(oldCount);
+            throw;
+        }
+    } else {
+        for (; first != last; ++first) {
+            emplaceBack(*first);
+        }
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::append(const Type* data, std::size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count > maxSize() - count_) {
+        throw "LengthError";
+    }
+
+    if (count_ + count > capacity_) {
+        if (data_ <= data && data < data_ + count_) {
+            // Источник лежит в нашем же буфере и переедет вместе с ним
+            std::size_t offset = static_cast<std::size_t>(data - data_);
+            reserve(count_ + count);
+            data = data_ + offset;
+        } else {
+            reserve(count_ + count);
+        }
+    }
+
+    detail::uninitializedCopy(allocator_, data, count, data_ + count_);
+    count_ += count;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template<typename Iterator>
+void Vector<Type, Allocator, GrowthPolicy>::insert(std::size_t index, Iterator first, Iterator last)
+{
+    using Category = typename std::iterator_traits<Iterator>::iterator_category;
+
+    if (index > count_) {
+        throw "IndexOutOfRange";
+    }
+
+    std::size_t oldCount = count_;
+    if constexpr (isTriviallyRelocatable<Type> && std::is_base_of<std::forward_iterator_tag, Category>::value) {
+        std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+        if (count == 0) {
+            return;
+        }
+        if (count > maxSize() - count_) {
+            throw "LengthError";
+        }
+        reserve(count_ + count);
+
+        // Хвост сдвигается одним memmove, в образовавшийся зазор копируется диапазон
+        Type* gap = data_ + index;
+        std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), (oldCount - index) * sizeof(Type));
+        std::size_t constructed = 0;
+        try {
+            for (; first != last; ++first, ++constructed) {
+                AllocatorTraits::construct(allocator_, gap + constructed, *first);
+            }
+        } catch (...) {
+            while (constructed > 0) {
+                AllocatorTraits::destroy(allocator_, gap + --constructed);
+            }
+            std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), (oldCount - index) * sizeof(Type));
+            throw;
+        }
+        count_ += count;
+    } else {
+        append(first, last);
+        std::rotate(data_ + index, data_ + oldCount, data_ + count_);
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::insert(std::size_t index, const Type& element)
+{
+    emplace(index, element);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::insert(std::size_t index, Type&& element)
+{
+    emplace(index, std::move(element));
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template <class ...Args>
+Type& Vector<Type, Allocator, GrowthPolicy>::emplace(std::size_t index, Args&&... args)
+{
+    if (index > count_) {
+        throw "IndexOutOfRange";
+    }
+    if (index == count_) {
+        return emplaceBack(std::forward<Args>(args)...);
+    }
+
+    // Аргументы могут ссылаться на сдвигаемые элементы, поэтому объект создаётся заранее
+    Type element(std::forward<Args>(args)...);
+    if (count_ == capacity_) {
+        if (capacity_ == maxSize()) {
+            throw "LengthError";
+        }
+        reserve(capacity_ + 1);
+    }
+
+    Type* gap = data_ + index;
+    if constexpr (isTriviallyRelocatable<Type> && std::is_nothrow_move_constructible<Type>::value) {
+        std::memmove(static_cast<void*>(gap + 1), static_cast<const void*>(gap), (count_ - index) * sizeof(Type));
+        AllocatorTraits::construct(allocator_, gap, std::move(element));
+        ++count_;
+    } else {
+        AllocatorTraits::construct(allocator_, data_ + count_, std::move(data_[count_ - 1]));
+        ++count_;
+        std::move_backward(gap, data_ + count_ - 2, data_ + count_ - 1);
+        *gap = std::move(element);
+    }
+    return *gap;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::erase(std::size_t index)
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+
+    erase(index, index + 1);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::erase(std::size_t first, std::size_t last)
+{
+    if (first > last || last > count_) {
+        throw "IndexOutOfRange";
+    }
+    if (first == last) {
+        return;
+    }
+
+    if constexpr (isTriviallyRelocatable<Type>) {
+        for (std::size_t i = first; i < last; ++i) {
+            AllocatorTraits::destroy(allocator_, data_ + i);
+        }
+        std::memmove(static_cast<void*>(data_ + first), static_cast<const void*>(data_ + last),
+                     (count_ - last) * sizeof(Type));
+        count_ -= last - first;
+    } else {
+        std::move(data_ + last, data_ + count_, data_ + first);
+        destroyTail(count_ - (last - first));
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::eraseUnordered(std::size_t index)
+{
+    if (index >= count_) {
+        throw "IndexOutOfRange";
+    }
+
+    if (index != count_ - 1) {
+        if constexpr (isTriviallyRelocatable<Type>) {
+            AllocatorTraits::destroy(allocator_, data_ + index);
+            std::memcpy(static_cast<void*>(data_ + index), static_cast<const void*>(data_ + count_ - 1), sizeof(Type));
+            --count_;
+            return;
+        } else {
+            data_[index] = std::move(data_[count_ - 1]);
+        }
+    }
+    destroyTail(count_ - 1);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::popBack()
+{
+    if (count_ == 0) {
+        throw "LogicError";
+    }
+
+    destroyTail(count_ - 1);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::assign(std::size_t count, const Type& value)
+{
+    if constexpr (lazyZero) {
+        if (count > capacity_ && count >= count_ && detail::isZeroBytes(value)) {
+            reallocateZeroed(count, 0);
+            return;
+        }
+    }
+
+    reserve(count);
+    if constexpr (std::is_trivially_copyable<Type>::value) {
+        detail::fillTrivial(data_, count, value);
+        count_ = std::max(count, count_);
+    } else {
+        std::size_t assigned = std::min(count, count_);
+        for (std::size_t i = 0; i < assigned; i++) {
+            data_[i] = value;
+        }
+        for (; count_ < count; ++count_) {
+            AllocatorTraits::construct(allocator_, data_ + count_, value);
+        }
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+const Type& Vector<Type, Allocator, GrowthPolicy>::back() const
+{
+    if(count_ > 0) {
+        return data_[count_ - 1];
+    }
+    throw "LogicError";
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+const Type& Vector<Type, Allocator, GrowthPolicy>::front() const
+{
+    if(count_ > 0) {
+        return data_[0];
+    }
+    throw "LogicError";
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+std::size_t Vector<Type, Allocator, GrowthPolicy>::capacity() const
+{
+    return capacity_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+std::size_t Vector<Type, Allocator, GrowthPolicy>::size() const
+{
+    return count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+std::size_t Vector<Type, Allocator, GrowthPolicy>::maxSize() const
+{
+    return AllocatorTraits::max_size(allocator_);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool Vector<Type, Allocator, GrowthPolicy>::empty() const
+{
+    return count_ == 0;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::clear()
+{
+    if (data_ != nullptr) {
+        destroyTail(0);
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+        data_ = nullptr;
+        capacity_ = 0;
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::resize(std::size_t count)
+{
+    if (count <= count_) {
+        destroyTail(count);
+        return;
+    }
+
+    if constexpr (lazyZero) {
+        // Новый обнулённый буфер окупается, только если сохраняемых элементов мало по сравнению
+        // с хвостом: иначе их копирование дороже, чем reallocate (realloc/mremap на месте) и
+        // заполнение нулями только хвоста
+        if (count > capacity_ && count_ <= count / 8) {
+            reallocateZeroed(count, count_);
+            return;
+        }
+    }
+
+    reserve(count);
+
+    if constexpr (std::is_scalar<Type>::value && !std::is_member_pointer<Type>::value) {
+        // Type() - нулевые байты (как в lazyZero): заполнение сводится к memset
+        detail::fillTrivial(data_ + count_, count - count_, Type());
+        count_ = count;
+    } else {
+        for (; count_ < count; ++count_) {
+            AllocatorTraits::construct(allocator_, data_ + count_);
+        }
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::resizeDefaultInit(std::size_t count)
+{
+    if (count <= count_) {
+        destroyTail(count);
+        return;
+    }
+
+    reserve(count);
+
+    if constexpr (std::is_trivially_default_constructible<Type>::value) {
+        count_ = count;
+    } else {
+        for (; count_ < count; ++count_) {
+            ::new (static_cast<void*>(data_ + count_)) Type;
+        }
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Type* Vector<Type, Allocator, GrowthPolicy>::growForOverwrite(std::size_t count)
+{
+    static_assert(std::is_trivial<Type>::value, "growForOverwrite requires a trivial type");
+
+    if (count > maxSize() - count_) {
+        throw "LengthError";
+    }
+    reserve(count_ + count);
+
+    Type* tail = data_ + count_;
+    count_ += count;
+    return tail;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::commitOverwritten(std::size_t count)
+{
+    static_assert(std::is_trivially_copyable<Type>::value && std::is_trivially_destructible<Type>::value,
+                  "commitOverwritten requires a trivially copyable and destructible type");
+
+    if (count > capacity_ - count_) {
+        throw "LengthError";
+    }
+    count_ += count;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::shrinkToFit()
+{
+    if (count_ == 0) {
+        clear();
+        return;
+    }
+
+    std::size_t newCapacity = GrowthPolicy::shrink(capacity_, count_, sizeof(Type));
+    if (newCapacity < capacity_) {
+        reallocate(newCapacity);
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Type& Vector<Type, Allocator, GrowthPolicy>::at(std::size_t index)
+{
+    if (index < count_) {
+        return data_[index];
+    }
+    throw "IndexOutOfRange";
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+const Type& Vector<Type, Allocator, GrowthPolicy>::at(std::size_t index) const
+{
+    if (index < count_) {
+        return data_[index];
+    }
+    throw "IndexOutOfRange";
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Type& Vector<Type, Allocator, GrowthPolicy>::operator[](std::size_t index)
+{
+    return data_[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+const Type& Vector<Type, Allocator, GrowthPolicy>::operator[](std::size_t index) const
+{
+    return data_[index];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Type* Vector<Type, Allocator, GrowthPolicy>::data()
+{
+    return data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+const Type* Vector<Type, Allocator, GrowthPolicy>::data() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::iterator Vector<Type, Allocator, GrowthPolicy>::begin()
+{
+    return data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_iterator Vector<Type, Allocator, GrowthPolicy>::begin() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_iterator Vector<Type, Allocator, GrowthPolicy>::cbegin() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::iterator Vector<Type, Allocator, GrowthPolicy>::end()
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_iterator Vector<Type, Allocator, GrowthPolicy>::end() const
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_iterator Vector<Type, Allocator, GrowthPolicy>::cend() const
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::reverse_iterator Vector<Type, Allocator, GrowthPolicy>::rbegin()
+{
+    return reverse_iterator(end());
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_reverse_iterator Vector<Type, Allocator, GrowthPolicy>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::reverse_iterator Vector<Type, Allocator, GrowthPolicy>::rend()
+{
+    return reverse_iterator(begin());
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+typename Vector<Type, Allocator, GrowthPolicy>::const_reverse_iterator Vector<Type, Allocator, GrowthPolicy>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+Allocator Vector<Type, Allocator, GrowthPolicy>::getAllocator() const
+{
+    return allocator_;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+bool Vector<Type, Allocator, GrowthPolicy>::migrate(int node)
+{
+    return numa::movePages(data_, capacity_ * sizeof(Type), node);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template <class ...Args>
+Type& Vector<Type, Allocator, GrowthPolicy>::emplaceBack(Args&&... args)
+{
+    if (count_ == capacity_) {
+        if (capacity_ == maxSize()) {
+            throw "LengthError";
+        }
+        // Аргументы могут ссылаться на элементы вектора, поэтому объект создаётся до переаллокации
+        Type element(std::forward<Args>(args)...);
+        reserve(capacity_ + 1);
+        AllocatorTraits::construct(allocator_, data_ + count_, std::move(element));
+    } else {
+        AllocatorTraits::construct(allocator_, data_ + count_, std::forward<Args>(args)...);
+    }
+    return data_[count_++];
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::swap(Vector& other)
+{
+    if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+        std::swap(allocator_, other.allocator_);
+    }
+    std::swap(data_, other.data_);
+    std::swap(count_, other.count_);
+    std::swap(capacity_, other.capacity_);
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::reallocate(std::size_t newCapacity)
+{
+    if constexpr (isTriviallyRelocatable<Type> && detail::HasReallocate<Allocator>::value) {
+        if (data_ != nullptr) {
+            data_ = allocator_.reallocate(data_, capacity_, newCapacity);
+            capacity_ = newCapacity;
+            return;
+        }
+    }
+
+    if (data_ != nullptr && detail::tryExpand(allocator_, data_, capacity_, newCapacity)) {
+        capacity_ = newCapacity;
+        return;
+    }
 
-template<typename Type>
-class Vector
+    Type* newData = AllocatorTraits::allocate(allocator_, newCapacity);
+    try {
+        detail::relocate(allocator_, data_, count_, newData);
+    } catch (...) {
+        AllocatorTraits::deallocate(allocator_, newData, newCapacity);
+        throw;
+    }
+
+    if (data_ != nullptr) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+    }
+    data_ = newData;
+    capacity_ = newCapacity;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::destroyTail(std::size_t first)
+{
+    while (count_ > first) {
+        AllocatorTraits::destroy(allocator_, data_ + --count_);
+    }
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+template<typename Expression>
+void Vector<Type, Allocator, GrowthPolicy>::evaluate(const Expression& expression)
+{
+    static_assert(std::is_arithmetic<Type>::value, "Vector expressions require arithmetic type");
+
+    // Если вектор входит в выражение, размеры совпадают и переаллокации не будет
+    const std::size_t count = expression.size();
+    if (count > capacity_) {
+        count_ = 0;
+        reallocate(count);
+    }
+
+    // Элемент i зависит только от элементов i операндов, поэтому запись поверх операнда
+    // не создаёт зависимостей между итерациями и цикл можно векторизовать
+    Type* data = data_;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC ivdep
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        data[i] = static_cast<Type>(expression[i]);
+    }
+    count_ = count;
+}
+
+
+
+template<typename Type, typename Allocator, typename GrowthPolicy>
+void Vector<Type, Allocator, GrowthPolicy>::reallocateZeroed(std::size_t count, std::size_t keep)
+{
+    std::size_t newCapacity = GrowthPolicy::grow(capacity_, count, maxSize(), sizeof(Type));
+    Type* newData = allocator_.allocateZeroed(newCapacity);
+    if (keep > 0) {
+        std::memcpy(static_cast<void*>(newData), static_cast<const void*>(data_), keep * sizeof(Type));
+    }
+
+    if (data_ != nullptr) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+    }
+    data_ = newData;
+    count_ = count;
+    capacity_ = newCapacity;
+}
+//***************************************************************************//
+
+
+
+namespace pmr
+{
+    // Vector на polymorphic_allocator: память берётся из переданного memory_resource,
+    // например из MonotonicArena, общей для всех векторов одного запроса
+    template<typename Type, typename GrowthPolicy = DoublingGrowth>
+    using Vector = ::Vector<Type, std::pmr::polymorphic_allocator<Type>, GrowthPolicy>;
+}
+
+
+
+// Вектор, хранящий до N элементов внутри самого объекта (без обращения к куче).
+// При превышении N элементы прозрачно переносятся в кучу; интерфейс совпадает с Vector
+template<typename Type, std::size_t N, typename Allocator = std::allocator<Type>>
+class SmallVector
 {
   public:
 
+    using value_type = Type;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Type&;
+    using const_reference = const Type&;
+    using pointer = Type*;
+    using const_pointer = const Type*;
+
+    // Итераторы - указатели, как у Vector: элементы непрерывны и во встроенном буфере, и в куче
+    using iterator = Type*;
+    using const_iterator = const Type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
     // Стандартный конструктор
-    Vector();
+    SmallVector();
 
     // Конструктор копирования
-    Vector(const Vector& other);
+    SmallVector(const SmallVector& other);
 
     // Оператор копирующего присваивания
-    Vector& operator=(const Vector& other);
+    SmallVector& operator=(const SmallVector& other);
 
-    // Конструктор перемещения
-    Vector(Vector&& other);
+    // Конструктор перемещения; встроенные элементы переносятся поштучно, поэтому noexcept зависит от Type
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<Type>::value);
 
     // Оператор присваивания перемещением
-    Vector& operator=(Vector&& other);
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<Type>::value);
 
     // Деструктор
-    ~Vector();
+    ~SmallVector();
 
-    // Добавить элемент в конец вектора
+    // Добавить копию элемента в конец вектора
     void pushBack(const Type& element);
 
+    // Переместить элемент в конец вектора
+    void pushBack(Type&& element);
+
     // Удалить элемент из конца вектора
     void popBack();
 
@@ -43,7 +1397,7 @@ class Vector
     // Вовзрат ссылки на первый элемент в векторе
     const Type& front() const;
 
-    // Вовзращает текущую вместимость вектора
+    // Вовзращает текущую вместимость вектора (не меньше N)
     std::size_t capacity() const;
 
     // Возвращает текущую заполненность вектора
@@ -55,7 +1409,10 @@ class Vector
     // Вовзращает true, если вектор пустой, иначе - false
     bool empty() const;
 
-    // Очищает вектор
+    // Вовзращает true, если элементы хранятся во встроенном буфере
+    bool isInline() const;
+
+    // Очищает вектор и возвращает его во встроенный буфер
     void clear();
 
     // Выделяет память для хранения как минимум size элементов типа Type, не инициализируя
@@ -64,7 +1421,8 @@ class Vector
     // Создаёт в векторе count элементов и инициализирует их стандартными значениями
     void resize(std::size_t count);
 
-    // Если неиспользуемой памяти слишком много, то сокращает её размер до 2^round(log2(count_))
+    // Возвращает элементы во встроенный буфер, если они там помещаются,
+    // иначе сокращает память в куче до 2^round(log2(count_))
     void shrinkToFit();
 
     // Возвращает ссылку на элемент в позиции index
@@ -79,17 +1437,69 @@ class Vector
     // Возвращает константную ссылку на элемент в позиции index
     const Type& operator[](std::size_t index) const;
 
-    // ToDo: TEST IT BETTER
-    // Конструирование элементов в конце вектора
+    // Возвращает указатель на первый элемент
+    Type* data();
+
+    // Возвращает константный указатель на первый элемент
+    const Type* data() const;
+
+    // Итератор на первый элемент
+    iterator begin();
+
+    // Константный итератор на первый элемент
+    const_iterator begin() const;
+
+    // Константный итератор на первый элемент
+    const_iterator cbegin() const;
+
+    // Итератор за последним элементом
+    iterator end();
+
+    // Константный итератор за последним элементом
+    const_iterator end() const;
+
+    // Константный итератор за последним элементом
+    const_iterator cend() const;
+
+    // Обратный итератор на последний элемент
+    reverse_iterator rbegin();
+
+    // Константный обратный итератор на последний элемент
+    const_reverse_iterator rbegin() const;
+
+    // Обратный итератор перед первым элементом
+    reverse_iterator rend();
+
+    // Константный обратный итератор перед первым элементом
+    const_reverse_iterator rend() const;
+
+    // Конструирует элемент в конце вектора прямо в его памяти из args,
+    // возвращает ссылку на созданный элемент
     template <class ...Args>
-    void emplaceBack(Args&&... args);
+    Type& emplaceBack(Args&&... args);
 
   private:
 
-    // Обмен значениями
-    void swap(Vector& other);
+    static_assert(N > 0, "SmallVector requires non-zero inline capacity");
+
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    // Начало встроенного буфера
+    Type* inlineData();
+
+    // Забирает элементы other, оставляя его пустым во встроенном буфере. *this должен быть пуст
+    void moveFrom(SmallVector& other);
+
+    // Переносит элементы в буфер вместимостью newCapacity (встроенный, если newCapacity == N)
+    void reallocate(std::size_t newCapacity);
 
-    // Указатель на массив с данными
+    // Вызывает деструкторы элементов в позициях [first, count_) и уменьшает count_
+    void destroyTail(std::size_t first);
+
+    // Аллокатор для буфера в куче
+    Allocator allocator_;
+
+    // Указатель на встроенный буфер или буфер в куче
     Type* data_;
 
     // Заполненость
@@ -97,142 +1507,126 @@ class Vector
 
     // Вместимость
     std::size_t capacity_;
+
+    // Встроенный буфер на N элементов
+    alignas(Type) unsigned char inline_[N * sizeof(Type)];
 };
 
 
 
 //***************************************************************************//
-template<typename Type>
-Vector<Type>::Vector()
-    : data_{nullptr}, count_{0}, capacity_{0}
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>::SmallVector()
+    : allocator_{}, data_{inlineData()}, count_{0}, capacity_{N}
 {
 }
 
 
 
-template<typename Type>
-Vector<Type>::Vector(const Vector<Type>& other)
-    : data_{nullptr}, count_{other.count_}, capacity_{other.capacity_}
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>::SmallVector(const SmallVector& other)
+    : SmallVector()
 {
-    if (capacity_ != 0) {
-        data_ = new Type[capacity_];
-        std::copy(other.data_, other.data_ + count_, data_);
-    }
+    reserve(other.count_);
+    detail::uninitializedCopy(allocator_, other.data_, other.count_, data_);
+    count_ = other.count_;
 }
 
 
 
-template<typename Type>
-Vector<Type>::Vector(Vector<Type>&& other)
-    : Vector()
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<Type>::value)
+    : SmallVector()
 {
-    swap(other);
+    moveFrom(other);
 }
 
 
 
-template<typename Type>
-Vector<Type>& Vector<Type>::operator=(const Vector<Type>& other)
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>& SmallVector<Type, N, Allocator>::operator=(const SmallVector& other)
 {
     if (this != &other) {
-        Vector<Type> tmp(other);
-        tmp.swap(*this);
+        SmallVector tmp(other);
+        clear();
+        moveFrom(tmp);
     }
     return *this;
 }
 
 
 
-template<typename Type>
-Vector<Type>& Vector<Type>::operator=(Vector<Type>&& other)
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>& SmallVector<Type, N, Allocator>::operator=(SmallVector&& other)
+    noexcept(std::is_nothrow_move_constructible<Type>::value)
 {
-    swap(other);
+    if (this != &other) {
+        clear();
+        moveFrom(other);
+    }
     return *this;
 }
 
 
 
-template<typename Type>
-Vector<Type>::~Vector()
+template<typename Type, std::size_t N, typename Allocator>
+SmallVector<Type, N, Allocator>::~SmallVector()
 {
     clear();
 }
 
 
 
-template<typename Type>
-void Vector<Type>::reserve(std::size_t size)
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::pushBack(const Type& element)
 {
-    if (size <= capacity_) {
-        return;
-    }
-
-    std::size_t newCapacity = capacity_ * 2;
-    if (newCapacity == 0) {
-        newCapacity = 1;
-    }
-    while (size > newCapacity) {
-        newCapacity *= 2;
-        if (newCapacity < capacity_) {
-            newCapacity = maxSize();
-            break;
-        }
-    }
-    Type* newData = new Type[newCapacity];
-    std::copy(data_, data_ + count_, newData);
-
-    delete[] data_;
-    data_ = newData;
-    capacity_ = newCapacity;
+    emplaceBack(element);
 }
 
 
 
-template<typename Type>
-void Vector<Type>::pushBack(const Type& element)
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::pushBack(Type&& element)
 {
-    if (count_ == capacity_) {
-        if (capacity_ == maxSize()) {
-            throw "LengthError";
-        }
-        reserve(capacity_ + 1);
-    }
-
-    data_[count_] = element;
-    ++count_;
+    emplaceBack(std::move(element));
 }
 
 
 
-template<typename Type>
-void Vector<Type>::popBack()
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::popBack()
 {
     if (count_ == 0) {
         throw "LogicError";
     }
 
-    data_[count_ - 1].~Type();
-    --count_;
+    destroyTail(count_ - 1);
 }
 
 
 
-template<typename Type>
-void Vector<Type>::assign(std::size_t count, const Type& value)
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::assign(std::size_t count, const Type& value)
 {
     reserve(count);
-    for (std::size_t i = 0; i < count; i++) {
-        data_[i] = value;
-    }
-    if (count > count_) {
-        count_ = count;
+    if constexpr (std::is_trivially_copyable<Type>::value) {
+        detail::fillTrivial(data_, count, value);
+        count_ = std::max(count, count_);
+    } else {
+        std::size_t assigned = std::min(count, count_);
+        for (std::size_t i = 0; i < assigned; i++) {
+            data_[i] = value;
+        }
+        for (; count_ < count; ++count_) {
+            AllocatorTraits::construct(allocator_, data_ + count_, value);
+        }
     }
 }
 
 
 
-template<typename Type>
-const Type& Vector<Type>::back() const
+template<typename Type, std::size_t N, typename Allocator>
+const Type& SmallVector<Type, N, Allocator>::back() const
 {
     if(count_ > 0) {
         return data_[count_ - 1];
@@ -242,8 +1636,8 @@ const Type& Vector<Type>::back() const
 
 
 
-template<typename Type>
-const Type& Vector<Type>::front() const
+template<typename Type, std::size_t N, typename Allocator>
+const Type& SmallVector<Type, N, Allocator>::front() const
 {
     if(count_ > 0) {
         return data_[0];
@@ -253,98 +1647,110 @@ const Type& Vector<Type>::front() const
 
 
 
-template<typename Type>
-std::size_t Vector<Type>::capacity() const
+template<typename Type, std::size_t N, typename Allocator>
+std::size_t SmallVector<Type, N, Allocator>::capacity() const
 {
     return capacity_;
 }
 
 
 
-template<typename Type>
-std::size_t Vector<Type>::size() const
+template<typename Type, std::size_t N, typename Allocator>
+std::size_t SmallVector<Type, N, Allocator>::size() const
 {
     return count_;
 }
 
 
 
-template <typename Type>
-std::size_t Vector<Type>::maxSize() const
+template<typename Type, std::size_t N, typename Allocator>
+std::size_t SmallVector<Type, N, Allocator>::maxSize() const
 {
-    return std::numeric_limits<std::size_t>::max();
+    return AllocatorTraits::max_size(allocator_);
 }
 
 
 
-template<typename Type>
-bool Vector<Type>::empty() const
+template<typename Type, std::size_t N, typename Allocator>
+bool SmallVector<Type, N, Allocator>::empty() const
 {
     return count_ == 0;
 }
 
 
 
-template<typename Type>
-void Vector<Type>::clear()
+template<typename Type, std::size_t N, typename Allocator>
+bool SmallVector<Type, N, Allocator>::isInline() const
 {
-    if (data_ != nullptr) {
-        delete[] data_;
-        data_ = nullptr;
-        count_ = 0;
-        capacity_ = 0;
+    return data_ == reinterpret_cast<const Type*>(inline_);
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::clear()
+{
+    destroyTail(0);
+    if (!isInline()) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+        data_ = inlineData();
+        capacity_ = N;
     }
 }
 
 
 
-template<typename Type>
-void Vector<Type>::resize(std::size_t count)
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::reserve(std::size_t size)
+{
+    if (size <= capacity_) {
+        return;
+    }
+
+    reallocate(DoublingGrowth::grow(capacity_, size, maxSize(), sizeof(Type)));
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::resize(std::size_t count)
 {
     if (count <= count_) {
-        while (count_ > count) {
-            popBack();
-            -- count_;
-        }
+        destroyTail(count);
         return;
     }
 
     reserve(count);
 
-    while(count_ < count) {
-        data_[count_] = Type();
-        ++count_;
+    for (; count_ < count; ++count_) {
+        AllocatorTraits::construct(allocator_, data_ + count_);
     }
 }
 
 
 
-template<typename Type>
-void Vector<Type>::shrinkToFit()
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::shrinkToFit()
 {
-    if (count_ == 0) {
-        clear();
+    if (isInline()) {
         return;
     }
 
-    if (count_ <= (capacity_ / 2)) {
-        std::size_t newCapacity = capacity_ / 2;
-        while (count_ <= (newCapacity / 2)) {
-            newCapacity /= 2;
-        }
-        Type* newData = new Type[newCapacity];
-        std::copy(data_, data_ + count_, newData);
+    if (count_ <= N) {
+        reallocate(N);
+        return;
+    }
 
-        delete[] data_;
-        data_ = newData;
-        capacity_ = newCapacity;
+    std::size_t newCapacity = DoublingGrowth::shrink(capacity_, count_, sizeof(Type));
+    if (newCapacity < capacity_) {
+        reallocate(newCapacity);
     }
 }
 
 
 
-template<typename Type>
-Type& Vector<Type>::at(std::size_t index)
+template<typename Type, std::size_t N, typename Allocator>
+Type& SmallVector<Type, N, Allocator>::at(std::size_t index)
 {
     if (index < count_) {
         return data_[index];
@@ -354,8 +1760,8 @@ Type& Vector<Type>::at(std::size_t index)
 
 
 
-template<typename Type>
-const Type& Vector<Type>::at(std::size_t index) const
+template<typename Type, std::size_t N, typename Allocator>
+const Type& SmallVector<Type, N, Allocator>::at(std::size_t index) const
 {
     if (index < count_) {
         return data_[index];
@@ -365,45 +1771,201 @@ const Type& Vector<Type>::at(std::size_t index) const
 
 
 
-template<typename Type>
-Type& Vector<Type>::operator[](std::size_t index)
+template<typename Type, std::size_t N, typename Allocator>
+Type& SmallVector<Type, N, Allocator>::operator[](std::size_t index)
 {
     return data_[index];
 }
 
 
 
-template<typename Type>
-const Type& Vector<Type>::operator[](std::size_t index) const
+template<typename Type, std::size_t N, typename Allocator>
+const Type& SmallVector<Type, N, Allocator>::operator[](std::size_t index) const
 {
     return data_[index];
 }
 
 
 
-// ToDo: TEST IT BETTER
-template <class Type>
+template<typename Type, std::size_t N, typename Allocator>
+Type* SmallVector<Type, N, Allocator>::data()
+{
+    return data_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+const Type* SmallVector<Type, N, Allocator>::data() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::iterator SmallVector<Type, N, Allocator>::begin()
+{
+    return data_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_iterator SmallVector<Type, N, Allocator>::begin() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_iterator SmallVector<Type, N, Allocator>::cbegin() const
+{
+    return data_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::iterator SmallVector<Type, N, Allocator>::end()
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_iterator SmallVector<Type, N, Allocator>::end() const
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_iterator SmallVector<Type, N, Allocator>::cend() const
+{
+    return data_ + count_;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::reverse_iterator SmallVector<Type, N, Allocator>::rbegin()
+{
+    return reverse_iterator(end());
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_reverse_iterator SmallVector<Type, N, Allocator>::rbegin() const
+{
+    return const_reverse_iterator(end());
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::reverse_iterator SmallVector<Type, N, Allocator>::rend()
+{
+    return reverse_iterator(begin());
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+typename SmallVector<Type, N, Allocator>::const_reverse_iterator SmallVector<Type, N, Allocator>::rend() const
+{
+    return const_reverse_iterator(begin());
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
 template <class ...Args>
-void Vector<Type>::emplaceBack(Args&&... args)
+Type& SmallVector<Type, N, Allocator>::emplaceBack(Args&&... args)
 {
-    pushBack(std::move(Type(args...)));
+    if (count_ == capacity_) {
+        if (capacity_ == maxSize()) {
+            throw "LengthError";
+        }
+        // Аргументы могут ссылаться на элементы вектора, поэтому объект создаётся до переаллокации
+        Type element(std::forward<Args>(args)...);
+        reserve(capacity_ + 1);
+        AllocatorTraits::construct(allocator_, data_ + count_, std::move(element));
+    } else {
+        AllocatorTraits::construct(allocator_, data_ + count_, std::forward<Args>(args)...);
+    }
+    return data_[count_++];
 }
 
 
 
-template<class Type>
-void Vector<Type>::swap(Vector<Type>& other)
+template<typename Type, std::size_t N, typename Allocator>
+Type* SmallVector<Type, N, Allocator>::inlineData()
 {
-    std::swap(data_, other.data_);
-    std::swap(count_, other.count_);
-    std::swap(capacity_, other.capacity_);
+    return reinterpret_cast<Type*>(inline_);
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::moveFrom(SmallVector& other)
+{
+    if (other.isInline()) {
+        detail::relocate(allocator_, other.data_, other.count_, data_);
+        count_ = other.count_;
+        other.count_ = 0;
+        return;
+    }
+
+    data_ = other.data_;
+    count_ = other.count_;
+    capacity_ = other.capacity_;
+    other.data_ = other.inlineData();
+    other.count_ = 0;
+    other.capacity_ = N;
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::reallocate(std::size_t newCapacity)
+{
+    Type* newData = newCapacity <= N ? inlineData() : AllocatorTraits::allocate(allocator_, newCapacity);
+    try {
+        detail::relocate(allocator_, data_, count_, newData);
+    } catch (...) {
+        if (newData != inlineData()) {
+            AllocatorTraits::deallocate(allocator_, newData, newCapacity);
+        }
+        throw;
+    }
+
+    if (!isInline()) {
+        AllocatorTraits::deallocate(allocator_, data_, capacity_);
+    }
+    data_ = newData;
+    capacity_ = std::max(newCapacity, N);
+}
+
+
+
+template<typename Type, std::size_t N, typename Allocator>
+void SmallVector<Type, N, Allocator>::destroyTail(std::size_t first)
+{
+    while (count_ > first) {
+        AllocatorTraits::destroy(allocator_, data_ + --count_);
+    }
 }
 //***************************************************************************//
 
 
 
-template<typename T>
-std::ostream& operator<<(std::ostream& out, const Vector<T> &v)
+template<typename T, typename Allocator, typename GrowthPolicy>
+std::ostream& operator<<(std::ostream& out, const Vector<T, Allocator, GrowthPolicy> &v)
 {
     if (v.empty()) {
         out << "";
@@ -416,4 +1978,17 @@ std::ostream& operator<<(std::ostream& out, const Vector<T> &v)
     return out;
 }
 
+
+
+
+template<typename T, std::size_t N, typename Allocator>
+std::ostream& operator<<(std::ostream& out, const SmallVector<T, N, Allocator> &v)
+{
+    for (std::size_t i = 0; i < v.size(); i++) {
+        out << v[i] << " ";
+    }
+
+    return out;
+}
+
 #endif // VECTOR_HPP
@@ -0,0 +1,275 @@
+﻿#ifndef VECTOR_EXPRESSIONS_HPP
+#define VECTOR_EXPRESSIONS_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+
+// Поэлементные операторы +, -, *, / и унарный минус для Vector с арифметическими элементами.
+// Результат оператора - ленивое выражение, которое хранит операнды и ничего не вычисляет;
+// значения считаются одним проходом при конструировании или присваивании Vector:
+//   Vector<double> r = a * b + c * d;   // без временных векторов для a * b и c * d
+// Операндами могут быть Vector, выражения и числа. Векторы в выражении хранятся по указателю
+// на данные, поэтому не должны изменяться или уничтожаться, пока выражение не вычислено.
+// Размеры векторов в выражении должны совпадать, иначе бросается "LogicError"
+
+
+
+namespace detail
+{
+    // Лист выражения - элементы вектора
+    template<typename Type>
+    class VectorOperand
+    {
+      public:
+
+        using value_type = Type;
+
+        static constexpr bool isScalar = false;
+
+        VectorOperand(const Type* data, std::size_t count) : data_(data), count_(count) {}
+
+        std::size_t size() const { return count_; }
+
+        const Type& operator[](std::size_t index) const { return data_[index]; }
+
+      private:
+
+        const Type* data_;
+
+        std::size_t count_;
+    };
+
+
+
+    // Лист выражения - число, одинаковое для всех позиций
+    template<typename Type>
+    class ScalarOperand
+    {
+      public:
+
+        using value_type = Type;
+
+        static constexpr bool isScalar = true;
+
+        explicit ScalarOperand(Type value) : value_(value) {}
+
+        std::size_t size() const { return 0; }
+
+        Type operator[](std::size_t) const { return value_; }
+
+      private:
+
+        Type value_;
+    };
+
+
+
+    // Узел Operation(left[i], right[i]). Вложенные выражения хранятся по значению, поэтому
+    // выражение можно сохранить в auto и вычислить позже
+    template<typename Left, typename Right, typename Operation>
+    class BinaryExpression
+    {
+      public:
+
+        using value_type = decltype(Operation::apply(std::declval<typename Left::value_type>(),
+                                                     std::declval<typename Right::value_type>()));
+
+        static constexpr bool isScalar = false;
+
+        BinaryExpression(const Left& left, const Right& right);
+
+        std::size_t size() const { return Left::isScalar ? right_.size() : left_.size(); }
+
+        value_type operator[](std::size_t index) const { return Operation::apply(left_[index], right_[index]); }
+
+      private:
+
+        Left left_;
+
+        Right right_;
+    };
+
+
+
+    // Узел Operation(operand[i])
+    template<typename Operand, typename Operation>
+    class UnaryExpression
+    {
+      public:
+
+        using value_type = decltype(Operation::apply(std::declval<typename Operand::value_type>()));
+
+        static constexpr bool isScalar = false;
+
+        explicit UnaryExpression(const Operand& operand) : operand_(operand) {}
+
+        std::size_t size() const { return operand_.size(); }
+
+        value_type operator[](std::size_t index) const { return Operation::apply(operand_[index]); }
+
+      private:
+
+        Operand operand_;
+    };
+
+
+
+    struct Plus
+    {
+        template<typename Left, typename Right>
+        static auto apply(Left left, Right right) { return left + right; }
+    };
+
+    struct Minus
+    {
+        template<typename Left, typename Right>
+        static auto apply(Left left, Right right) { return left - right; }
+    };
+
+    struct Multiplies
+    {
+        template<typename Left, typename Right>
+        static auto apply(Left left, Right right) { return left * right; }
+    };
+
+    struct Divides
+    {
+        template<typename Left, typename Right>
+        static auto apply(Left left, Right right) { return left / right; }
+    };
+
+    struct Negate
+    {
+        template<typename Operand>
+        static auto apply(Operand operand) { return -operand; }
+    };
+
+
+
+    // Как значение типа Type входит в выражение: Vector - листом VectorOperand,
+    // число - листом ScalarOperand, выражение - само собой
+    template<typename Type, typename = void>
+    struct ExpressionOperand
+    {
+        static constexpr bool value = false;
+    };
+
+    template<typename Type, typename Allocator, typename GrowthPolicy>
+    struct ExpressionOperand<Vector<Type, Allocator, GrowthPolicy>, std::enable_if_t<std::is_arithmetic<Type>::value>>
+    {
+        static constexpr bool value = true;
+
+        using type = VectorOperand<Type>;
+
+        static type wrap(const Vector<Type, Allocator, GrowthPolicy>& v) { return type(v.data(), v.size()); }
+    };
+
+    template<typename Type>
+    struct ExpressionOperand<Type, std::enable_if_t<std::is_arithmetic<Type>::value>>
+    {
+        static constexpr bool value = true;
+
+        using type = ScalarOperand<Type>;
+
+        static type wrap(Type value) { return type(value); }
+    };
+
+    template<typename Type>
+    struct ExpressionOperand<Type, std::enable_if_t<IsVectorExpression<Type>::value>>
+    {
+        static constexpr bool value = true;
+
+        using type = Type;
+
+        static const type& wrap(const Type& expression) { return expression; }
+    };
+
+    // Операторы участвуют в разрешении перегрузки, только если оба операнда подходят
+    // и хотя бы один из них - вектор или выражение
+    template<typename Left, typename Right>
+    using EnableBinaryExpression = std::enable_if_t<ExpressionOperand<Left>::value && ExpressionOperand<Right>::value &&
+                                                    !(std::is_arithmetic<Left>::value && std::is_arithmetic<Right>::value),
+                                                    int>;
+
+    template<typename Operation, typename Left, typename Right>
+    BinaryExpression<typename ExpressionOperand<Left>::type, typename ExpressionOperand<Right>::type, Operation>
+    makeExpression(const Left& left, const Right& right)
+    {
+        return {ExpressionOperand<Left>::wrap(left), ExpressionOperand<Right>::wrap(right)};
+    }
+}
+
+
+
+template<typename Left, typename Right, typename Operation>
+struct IsVectorExpression<detail::BinaryExpression<Left, Right, Operation>> : std::true_type
+{
+};
+
+template<typename Operand, typename Operation>
+struct IsVectorExpression<detail::UnaryExpression<Operand, Operation>> : std::true_type
+{
+};
+
+
+
+template<typename Left, typename Right, detail::EnableBinaryExpression<Left, Right> = 0>
+auto operator+(const Left& left, const Right& right)
+{
+    return detail::makeExpression<detail::Plus>(left, right);
+}
+
+
+
+template<typename Left, typename Right, detail::EnableBinaryExpression<Left, Right> = 0>
+auto operator-(const Left& left, const Right& right)
+{
+    return detail::makeExpression<detail::Minus>(left, right);
+}
+
+
+
+template<typename Left, typename Right, detail::EnableBinaryExpression<Left, Right> = 0>
+auto operator*(const Left& left, const Right& right)
+{
+    return detail::makeExpression<detail::Multiplies>(left, right);
+}
+
+
+
+template<typename Left, typename Right, detail::EnableBinaryExpression<Left, Right> = 0>
+auto operator/(const Left& left, const Right& right)
+{
+    return detail::makeExpression<detail::Divides>(left, right);
+}
+
+
+
+template<typename Operand, std::enable_if_t<detail::ExpressionOperand<Operand>::value &&
+                                            !std::is_arithmetic<Operand>::value, int> = 0>
+auto operator-(const Operand& operand)
+{
+    using Wrapped = typename detail::ExpressionOperand<Operand>::type;
+    return detail::UnaryExpression<Wrapped, detail::Negate>(detail::ExpressionOperand<Operand>::wrap(operand));
+}
+
+
+
+//***************************************************************************//
+namespace detail
+{
+    template<typename Left, typename Right, typename Operation>
+    BinaryExpression<Left, Right, Operation>::BinaryExpression(const Left& left, const Right& right)
+        : left_(left), right_(right)
+    {
+        if (!Left::isScalar && !Right::isScalar && left.size() != right.size()) {
+            throw "LogicError";
+        }
+    }
+}
+//***************************************************************************//
+
+#endif // VECTOR_EXPRESSIONS_HPP
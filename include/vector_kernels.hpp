@@ -0,0 +1,1041 @@
+﻿#ifndef VECTOR_KERNELS_HPP
+#define VECTOR_KERNELS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Векторизованные свёртки и сканирование для арифметических контейнеров (Vector, SmallVector,
+// StaticVector и любых других с data()/size()). Векторные пути написаны на векторных расширениях
+// GCC и собираются под ширину 16 (SSE2/NEON), 32 (AVX2) или 64 (AVX-512) байт; без них работает
+// скалярная реализация.
+//
+// На x86 векторные пути собираются атрибутом target для SSE4.2, AVX2 и AVX-512 независимо от
+// флагов компилятора, а нужный выбирается во время выполнения по cpuid. Переменная окружения
+// VECTOR_KERNELS_ISA (scalar, sse4.2, avx2, avx512) ограничивает выбор сверху - для A/B-замеров.
+// На остальных платформах ширина фиксируется при сборке (simdWidth).
+//
+// sum раскладывает элементы по 64 / sizeof(Type) частичным суммам одинаково на всех путях,
+// поэтому результат не зависит от ширины регистров и совпадает со скалярным побитово.
+// dot при наличии FMA и prefixSum для чисел с плавающей точкой могут отличаться от
+// последовательного сложения в младших битах. NaN во входных данных min/max/argmin/argmax
+// не поддерживаются.
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define VECTOR_KERNEL_INLINE inline __attribute__((always_inline))
+#define VECTOR_KERNELS_SIMD 1
+#else
+#define VECTOR_KERNEL_INLINE inline
+#define VECTOR_KERNELS_SIMD 0
+#endif
+
+#if VECTOR_KERNELS_SIMD && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_KERNELS_DISPATCH 1
+#else
+#define VECTOR_KERNELS_DISPATCH 0
+#endif
+
+namespace kernels {
+
+// Ширина векторного регистра в байтах, под которую собраны ядра без выбора во время
+// выполнения (0 - только скалярный путь)
+#if VECTOR_KERNELS_SIMD && defined(__AVX512F__)
+constexpr std::size_t simdWidth = 64;
+#elif VECTOR_KERNELS_SIMD && defined(__AVX2__)
+constexpr std::size_t simdWidth = 32;
+#elif VECTOR_KERNELS_SIMD && (defined(__SSE2__) || defined(__ARM_NEON))
+constexpr std::size_t simdWidth = 16;
+#else
+constexpr std::size_t simdWidth = 0;
+#endif
+
+// Наборы инструкций, между которыми ядра выбираются во время выполнения
+enum class Isa
+{
+    Scalar,
+    Sse42,
+    Avx2,
+    Avx512
+};
+
+// Самый широкий набор, который поддерживают процессор и ОС; Scalar без выбора во время выполнения
+inline Isa detectedIsa();
+
+// Набор, которым пользуются ядра: detectedIsa(), ограниченный VECTOR_KERNELS_ISA
+inline Isa activeIsa();
+
+// Переключает ядра на isa, но не шире detectedIsa(); возвращает фактически выбранный набор
+inline Isa setIsa(Isa isa);
+
+inline const char* isaName(Isa isa);
+
+// Набор по имени из VECTOR_KERNELS_ISA; false для неизвестного имени
+inline bool parseIsa(const char* name, Isa& isa);
+
+// Заполняет count элементов значением value
+template<typename Type>
+void fill(Type* data, std::size_t count, Type value);
+
+// Копирует count элементов; диапазоны не должны перекрываться
+template<typename Type>
+void copy(const Type* source, std::size_t count, Type* destination);
+
+
+
+// Сумма элементов; целые переполняются по модулю 2^n
+template<typename Type>
+Type sum(const Type* data, std::size_t count);
+
+// Скалярное произведение a и b длины count
+template<typename Type>
+Type dot(const Type* a, const Type* b, std::size_t count);
+
+// Индекс первого минимального элемента, count для пустого диапазона
+template<typename Type>
+std::size_t argmin(const Type* data, std::size_t count);
+
+// Индекс первого максимального элемента, count для пустого диапазона
+template<typename Type>
+std::size_t argmax(const Type* data, std::size_t count);
+
+// Число элементов, равных value
+template<typename Type>
+std::size_t count(const Type* data, std::size_t count, Type value);
+
+// Индекс первого элемента, равного value, count если такого нет
+template<typename Type>
+std::size_t find(const Type* data, std::size_t count, Type value);
+
+// Включающая префиксная сумма: out[i] = data[0] + ... + data[i]; out может совпадать с data
+template<typename Type>
+void prefixSum(const Type* data, std::size_t count, Type* out);
+
+
+
+template<typename Container>
+typename Container::value_type sum(const Container& v);
+
+// Бросает "LogicError", если размеры a и b различаются
+template<typename Container>
+typename Container::value_type dot(const Container& a, const Container& b);
+
+// Бросает "LogicError" для пустого контейнера
+template<typename Container>
+const typename Container::value_type& min(const Container& v);
+
+// Бросает "LogicError" для пустого контейнера
+template<typename Container>
+const typename Container::value_type& max(const Container& v);
+
+template<typename Container>
+std::size_t argmin(const Container& v);
+
+template<typename Container>
+std::size_t argmax(const Container& v);
+
+template<typename Container>
+std::size_t count(const Container& v, const typename Container::value_type& value);
+
+template<typename Container>
+std::size_t find(const Container& v, const typename Container::value_type& value);
+
+// Заменяет элементы v их включающей префиксной суммой
+template<typename Container>
+void prefixSum(Container& v);
+
+
+
+namespace detail {
+
+template<typename Type>
+constexpr bool simdElement = std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value &&
+                             !std::is_same<Type, long double>::value;
+
+// Сложение и умножение, у которых переполнение целых определено (по модулю 2^n)
+template<typename Type>
+VECTOR_KERNEL_INLINE Type wrappingAdd(Type a, Type b)
+{
+    if constexpr (std::is_integral<Type>::value) {
+        using Wide = decltype(std::make_unsigned_t<Type>() + 0u);
+        return static_cast<Type>(static_cast<Wide>(a) + static_cast<Wide>(b));
+    } else {
+        return a + b;
+    }
+}
+
+
+
+template<typename Type>
+VECTOR_KERNEL_INLINE Type wrappingMul(Type a, Type b)
+{
+    if constexpr (std::is_integral<Type>::value) {
+        using Wide = decltype(std::make_unsigned_t<Type>() + 0u);
+        return static_cast<Type>(static_cast<Wide>(a) * static_cast<Wide>(b));
+    } else {
+        return a * b;
+    }
+}
+
+
+
+// Скалярные ядра: эталон для векторных путей и единственный путь без векторных расширений
+template<typename Type>
+struct ScalarKernels
+{
+    // Число частичных сумм в sum и dot - столько элементов помещается в 64 байта
+    static constexpr std::size_t partials = sizeof(Type) < 64 ? 64 / sizeof(Type) : 1;
+
+    static Type sum(const Type* data, std::size_t count);
+    static Type dot(const Type* a, const Type* b, std::size_t count);
+    static std::size_t argmin(const Type* data, std::size_t count);
+    static std::size_t argmax(const Type* data, std::size_t count);
+    static std::size_t count(const Type* data, std::size_t count, Type value);
+    static std::size_t find(const Type* data, std::size_t count, Type value);
+    static void prefixSum(const Type* data, std::size_t count, Type* out);
+    static void fill(Type* data, std::size_t count, Type value);
+    static void copy(const Type* source, std::size_t count, Type* destination);
+
+    // Сворачивает частичные суммы всегда в одном и том же порядке
+    static Type reducePartials(const Type* partial);
+};
+
+
+
+#if VECTOR_KERNELS_SIMD
+// Векторный тип GCC из Bytes / sizeof(Element) элементов; атрибут с зависимым размером
+// применяется только к зависимому типу элемента, поэтому тип строится через шаблон
+template<typename Element, std::size_t Bytes>
+struct VectorOf
+{
+    typedef Element type __attribute__((vector_size(Bytes)));
+};
+
+
+
+// Векторные ядра для регистров ширины Bytes. Все методы встраиваются в вызывающую функцию,
+// чтобы код генерировался под её набор инструкций
+template<typename Type, std::size_t Bytes>
+struct SimdKernels
+{
+    using Vec = typename VectorOf<Type, Bytes>::type;
+    using Mask = decltype(std::declval<Vec>() == std::declval<Vec>());
+    using Lane = std::remove_cv_t<std::remove_reference_t<decltype(std::declval<Mask&>()[0])>>;
+
+    static constexpr std::size_t lanes = Bytes / sizeof(Type);
+    // Регистров-аккумуляторов: вместе они держат те же частичные суммы, что и скалярный путь
+    static constexpr std::size_t unroll = ScalarKernels<Type>::partials / lanes;
+    static constexpr std::size_t block = lanes * unroll;
+
+    static VECTOR_KERNEL_INLINE Type sum(const Type* data, std::size_t count);
+    static VECTOR_KERNEL_INLINE Type dot(const Type* a, const Type* b, std::size_t count);
+    static VECTOR_KERNEL_INLINE std::size_t argmin(const Type* data, std::size_t count);
+    static VECTOR_KERNEL_INLINE std::size_t argmax(const Type* data, std::size_t count);
+    static VECTOR_KERNEL_INLINE std::size_t count(const Type* data, std::size_t count, Type value);
+    static VECTOR_KERNEL_INLINE std::size_t find(const Type* data, std::size_t count, Type value);
+    static VECTOR_KERNEL_INLINE void prefixSum(const Type* data, std::size_t count, Type* out);
+    static VECTOR_KERNEL_INLINE void fill(Type* data, std::size_t count, Type value);
+    static VECTOR_KERNEL_INLINE void copy(const Type* source, std::size_t count, Type* destination);
+
+  private:
+
+    // Векторы не передаются и не возвращаются по значению: иначе GCC предупреждает о смене
+    // ABI для функций, которые всё равно никогда не вызываются отдельно
+    static VECTOR_KERNEL_INLINE void load(Vec& v, const Type* p);
+    static VECTOR_KERNEL_INLINE void store(Type* p, const Vec& v);
+    // Заполняет v одинаковыми элементами; Vec{} + value потерял бы знак -0.0
+    static VECTOR_KERNEL_INLINE void splat(Vec& v, Type value);
+    static VECTOR_KERNEL_INLINE bool any(const Mask& m);
+
+    // Минимум (Less = true) или максимум значений диапазона, count > 0
+    template<bool Less>
+    static VECTOR_KERNEL_INLINE Type extremum(const Type* data, std::size_t count);
+
+    // Прибавляет к v его копию, сдвинутую на Shift позиций к старшим элементам
+    template<std::size_t Shift, std::size_t... I>
+    static VECTOR_KERNEL_INLINE void addShifted(Vec& v, std::index_sequence<I...>);
+
+    // Включающий префикс внутри регистра за log2(lanes) сдвигов
+    template<std::size_t Shift>
+    static VECTOR_KERNEL_INLINE void scanLanes(Vec& v);
+};
+#endif
+
+
+
+// Таблица ядер одного набора инструкций для элементов Type
+template<typename Type>
+struct KernelTable
+{
+    Type (*sum)(const Type*, std::size_t);
+    Type (*dot)(const Type*, const Type*, std::size_t);
+    std::size_t (*argmin)(const Type*, std::size_t);
+    std::size_t (*argmax)(const Type*, std::size_t);
+    std::size_t (*count)(const Type*, std::size_t, Type);
+    std::size_t (*find)(const Type*, std::size_t, Type);
+    void (*prefixSum)(const Type*, std::size_t, Type*);
+    void (*fill)(Type*, std::size_t, Type);
+    void (*copy)(const Type*, std::size_t, Type*);
+};
+
+template<typename Kernels, typename Type>
+constexpr KernelTable<Type> makeTable();
+
+// Таблица активного набора инструкций
+template<typename Type>
+const KernelTable<Type>& kernelTable();
+
+// Текущий набор инструкций; при первом обращении читает VECTOR_KERNELS_ISA
+inline std::atomic<Isa>& isaState();
+
+
+
+#if VECTOR_KERNELS_SIMD
+// Обёртка Name над SimdKernels<Type, Bytes>, функции которой - обычные (не встраиваемые)
+// функции с атрибутами Attributes: векторный код встраивается в них и собирается
+// под указанный в атрибутах набор инструкций
+#define VECTOR_KERNELS_TARGET(Name, Attributes, Bytes) \
+    template<typename Type> \
+    struct Name \
+    { \
+        using Simd = SimdKernels<Type, Bytes>; \
+        Attributes static Type sum(const Type* data, std::size_t count) \
+        { return Simd::sum(data, count); } \
+        Attributes static Type dot(const Type* a, const Type* b, std::size_t count) \
+        { return Simd::dot(a, b, count); } \
+        Attributes static std::size_t argmin(const Type* data, std::size_t count) \
+        { return Simd::argmin(data, count); } \
+        Attributes static std::size_t argmax(const Type* data, std::size_t count) \
+        { return Simd::argmax(data, count); } \
+        Attributes static std::size_t count(const Type* data, std::size_t count, Type value) \
+        { return Simd::count(data, count, value); } \
+        Attributes static std::size_t find(const Type* data, std::size_t count, Type value) \
+        { return Simd::find(data, count, value); } \
+        Attributes static void prefixSum(const Type* data, std::size_t count, Type* out) \
+        { Simd::prefixSum(data, count, out); } \
+        Attributes static void fill(Type* data, std::size_t count, Type value) \
+        { Simd::fill(data, count, value); } \
+        Attributes static void copy(const Type* source, std::size_t count, Type* destination) \
+        { Simd::copy(source, count, destination); } \
+    };
+
+#if VECTOR_KERNELS_DISPATCH
+VECTOR_KERNELS_TARGET(Sse42Kernels, __attribute__((target("sse4.2"))), 16)
+VECTOR_KERNELS_TARGET(Avx2Kernels, __attribute__((target("avx2"))), 32)
+VECTOR_KERNELS_TARGET(Avx512Kernels, __attribute__((target("avx512f,avx512bw"))), 64)
+#elif VECTOR_KERNELS_SIMD
+VECTOR_KERNELS_TARGET(BuildTargetKernels, , simdWidth)
+#endif
+
+#undef VECTOR_KERNELS_TARGET
+#endif
+
+} // namespace detail
+
+} // namespace kernels
+
+
+
+//***************************************************************************//
+namespace kernels {
+
+namespace detail {
+
+template<typename Type>
+Type ScalarKernels<Type>::sum(const Type* data, std::size_t count)
+{
+    Type partial[partials] = {};
+    std::size_t i = 0;
+    for (; i + partials <= count; i += partials) {
+        for (std::size_t j = 0; j < partials; ++j) {
+            partial[j] = wrappingAdd(partial[j], data[i + j]);
+        }
+    }
+    for (std::size_t j = 0; i < count; ++i, ++j) {
+        partial[j] = wrappingAdd(partial[j], data[i]);
+    }
+    return reducePartials(partial);
+}
+
+
+
+template<typename Type>
+Type ScalarKernels<Type>::dot(const Type* a, const Type* b, std::size_t count)
+{
+    Type partial[partials] = {};
+    std::size_t i = 0;
+    for (; i + partials <= count; i += partials) {
+        for (std::size_t j = 0; j < partials; ++j) {
+            partial[j] = wrappingAdd(partial[j], wrappingMul(a[i + j], b[i + j]));
+        }
+    }
+    for (std::size_t j = 0; i < count; ++i, ++j) {
+        partial[j] = wrappingAdd(partial[j], wrappingMul(a[i], b[i]));
+    }
+    return reducePartials(partial);
+}
+
+
+
+template<typename Type>
+std::size_t ScalarKernels<Type>::argmin(const Type* data, std::size_t count)
+{
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        if (data[i] < data[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+
+
+template<typename Type>
+std::size_t ScalarKernels<Type>::argmax(const Type* data, std::size_t count)
+{
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < count; ++i) {
+        if (data[best] < data[i]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+
+
+template<typename Type>
+std::size_t ScalarKernels<Type>::count(const Type* data, std::size_t count, Type value)
+{
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        result += data[i] == value;
+    }
+    return result;
+}
+
+
+
+template<typename Type>
+std::size_t ScalarKernels<Type>::find(const Type* data, std::size_t count, Type value)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return count;
+}
+
+
+
+template<typename Type>
+void ScalarKernels<Type>::prefixSum(const Type* data, std::size_t count, Type* out)
+{
+    Type running = Type();
+    for (std::size_t i = 0; i < count; ++i) {
+        running = wrappingAdd(running, data[i]);
+        out[i] = running;
+    }
+}
+
+
+
+template<typename Type>
+void ScalarKernels<Type>::fill(Type* data, std::size_t count, Type value)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        data[i] = value;
+    }
+}
+
+
+
+template<typename Type>
+void ScalarKernels<Type>::copy(const Type* source, std::size_t count, Type* destination)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        destination[i] = source[i];
+    }
+}
+
+
+
+template<typename Type>
+Type ScalarKernels<Type>::reducePartials(const Type* partial)
+{
+    Type result = partial[0];
+    for (std::size_t j = 1; j < partials; ++j) {
+        result = wrappingAdd(result, partial[j]);
+    }
+    return result;
+}
+
+
+
+#if VECTOR_KERNELS_SIMD
+template<typename Type, std::size_t Bytes>
+Type SimdKernels<Type, Bytes>::sum(const Type* data, std::size_t count)
+{
+    Vec acc[unroll] = {};
+    std::size_t i = 0;
+    for (; i + block <= count; i += block) {
+        for (std::size_t k = 0; k < unroll; ++k) {
+            Vec v;
+            load(v, data + i + k * lanes);
+            acc[k] += v;
+        }
+    }
+
+    Type partial[ScalarKernels<Type>::partials];
+    for (std::size_t k = 0; k < unroll; ++k) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            partial[k * lanes + j] = acc[k][j];
+        }
+    }
+    for (std::size_t j = 0; i < count; ++i, ++j) {
+        partial[j] = wrappingAdd(partial[j], data[i]);
+    }
+    return ScalarKernels<Type>::reducePartials(partial);
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+Type SimdKernels<Type, Bytes>::dot(const Type* a, const Type* b, std::size_t count)
+{
+    Vec acc[unroll] = {};
+    std::size_t i = 0;
+    for (; i + block <= count; i += block) {
+        for (std::size_t k = 0; k < unroll; ++k) {
+            Vec x, y;
+            load(x, a + i + k * lanes);
+            load(y, b + i + k * lanes);
+            acc[k] += x * y;
+        }
+    }
+
+    Type partial[ScalarKernels<Type>::partials];
+    for (std::size_t k = 0; k < unroll; ++k) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            partial[k * lanes + j] = acc[k][j];
+        }
+    }
+    for (std::size_t j = 0; i < count; ++i, ++j) {
+        partial[j] = wrappingAdd(partial[j], wrappingMul(a[i], b[i]));
+    }
+    return ScalarKernels<Type>::reducePartials(partial);
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+std::size_t SimdKernels<Type, Bytes>::argmin(const Type* data, std::size_t count)
+{
+    // Два векторных прохода (значение минимума, затем его первое вхождение) вместо
+    // одного с отслеживанием индексов в каждой дорожке
+    return count == 0 ? 0 : find(data, count, extremum<true>(data, count));
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+std::size_t SimdKernels<Type, Bytes>::argmax(const Type* data, std::size_t count)
+{
+    return count == 0 ? 0 : find(data, count, extremum<false>(data, count));
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+std::size_t SimdKernels<Type, Bytes>::count(const Type* data, std::size_t count, Type value)
+{
+    // Счётчики дорожек переполнились бы на длинных диапазонах, поэтому сбрасываются
+    // в result не реже чем через flush регистров
+    constexpr std::size_t flush = sizeof(Lane) == 1 ? 127 : 32767;
+
+    std::size_t result = 0;
+    std::size_t i = 0;
+    while (i + lanes <= count) {
+        Mask counter = {};
+        for (std::size_t n = 0; n < flush && i + lanes <= count; ++n, i += lanes) {
+            Vec v;
+            load(v, data + i);
+            counter -= v == value;
+        }
+        for (std::size_t j = 0; j < lanes; ++j) {
+            result += static_cast<std::size_t>(counter[j]);
+        }
+    }
+    for (; i < count; ++i) {
+        result += data[i] == value;
+    }
+    return result;
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+std::size_t SimdKernels<Type, Bytes>::find(const Type* data, std::size_t count, Type value)
+{
+    // Маски четырёх регистров объединяются, и дорогая проверка any выполняется одна на всех
+    std::size_t i = 0;
+    for (; i + 4 * lanes <= count; i += 4 * lanes) {
+        Vec v[4];
+        for (std::size_t k = 0; k < 4; ++k) {
+            load(v[k], data + i + k * lanes);
+        }
+        if (any((v[0] == value) | (v[1] == value) | (v[2] == value) | (v[3] == value))) {
+            break;
+        }
+    }
+    for (; i < count; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return count;
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::prefixSum(const Type* data, std::size_t count, Type* out)
+{
+    Vec carry = {};
+    std::size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        Vec v;
+        load(v, data + i);
+        scanLanes<1>(v);
+        v += carry;
+        store(out + i, v);
+        splat(carry, v[lanes - 1]);
+    }
+
+    Type running = carry[0];
+    for (; i < count; ++i) {
+        running = wrappingAdd(running, data[i]);
+        out[i] = running;
+    }
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::fill(Type* data, std::size_t count, Type value)
+{
+    Vec v;
+    splat(v, value);
+    std::size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        store(data + i, v);
+    }
+    for (; i < count; ++i) {
+        data[i] = value;
+    }
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::copy(const Type* source, std::size_t count, Type* destination)
+{
+    std::size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        Vec v;
+        load(v, source + i);
+        store(destination + i, v);
+    }
+    for (; i < count; ++i) {
+        destination[i] = source[i];
+    }
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::load(Vec& v, const Type* p)
+{
+    std::memcpy(&v, p, sizeof(v));
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::store(Type* p, const Vec& v)
+{
+    std::memcpy(p, &v, sizeof(v));
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+void SimdKernels<Type, Bytes>::splat(Vec& v, Type value)
+{
+    for (std::size_t j = 0; j < lanes; ++j) {
+        v[j] = value;
+    }
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+bool SimdKernels<Type, Bytes>::any(const Mask& m)
+{
+    using Words = typename VectorOf<unsigned long long, Bytes>::type;
+    Words words = reinterpret_cast<Words>(m);
+    unsigned long long result = 0;
+    for (std::size_t j = 0; j < Bytes / sizeof(unsigned long long); ++j) {
+        result |= words[j];
+    }
+    return result != 0;
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+template<bool Less>
+Type SimdKernels<Type, Bytes>::extremum(const Type* data, std::size_t count)
+{
+    Type result = data[0];
+    std::size_t i = 0;
+    if (count >= block) {
+        Vec best[unroll];
+        for (std::size_t k = 0; k < unroll; ++k) {
+            load(best[k], data + k * lanes);
+        }
+        for (i = block; i + block <= count; i += block) {
+            for (std::size_t k = 0; k < unroll; ++k) {
+                Vec v;
+                load(v, data + i + k * lanes);
+                best[k] = Less ? (v < best[k] ? v : best[k]) : (best[k] < v ? v : best[k]);
+            }
+        }
+        for (std::size_t k = 0; k < unroll; ++k) {
+            for (std::size_t j = 0; j < lanes; ++j) {
+                if (Less ? best[k][j] < result : result < best[k][j]) {
+                    result = best[k][j];
+                }
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        if (Less ? data[i] < result : result < data[i]) {
+            result = data[i];
+        }
+    }
+    return result;
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+template<std::size_t Shift, std::size_t... I>
+void SimdKernels<Type, Bytes>::addShifted(Vec& v, std::index_sequence<I...>)
+{
+    // Индексы >= lanes выбирают элементы второго (нулевого) регистра
+    v += __builtin_shuffle(v, Vec{}, Mask{static_cast<Lane>(I >= Shift ? I - Shift : lanes + I)...});
+}
+
+
+
+template<typename Type, std::size_t Bytes>
+template<std::size_t Shift>
+void SimdKernels<Type, Bytes>::scanLanes(Vec& v)
+{
+    if constexpr (Shift < lanes) {
+        addShifted<Shift>(v, std::make_index_sequence<lanes>());
+        scanLanes<Shift * 2>(v);
+    }
+}
+#endif
+
+
+
+
+template<typename Kernels, typename Type>
+constexpr KernelTable<Type> makeTable()
+{
+    return {&Kernels::sum, &Kernels::dot, &Kernels::argmin, &Kernels::argmax, &Kernels::count,
+            &Kernels::find, &Kernels::prefixSum, &Kernels::fill, &Kernels::copy};
+}
+
+
+
+template<typename Type>
+const KernelTable<Type>& kernelTable()
+{
+    if constexpr (!simdElement<Type>) {
+        static const KernelTable<Type> table = makeTable<ScalarKernels<Type>, Type>();
+        return table;
+    } else {
+#if VECTOR_KERNELS_DISPATCH
+        static const KernelTable<Type> tables[] = {
+            makeTable<ScalarKernels<Type>, Type>(), makeTable<Sse42Kernels<Type>, Type>(),
+            makeTable<Avx2Kernels<Type>, Type>(), makeTable<Avx512Kernels<Type>, Type>()};
+        return tables[static_cast<int>(isaState().load(std::memory_order_relaxed))];
+#elif VECTOR_KERNELS_SIMD
+        if constexpr (simdWidth != 0) {
+            static const KernelTable<Type> table = makeTable<BuildTargetKernels<Type>, Type>();
+            return table;
+        } else {
+            static const KernelTable<Type> table = makeTable<ScalarKernels<Type>, Type>();
+            return table;
+        }
+#else
+        static const KernelTable<Type> table = makeTable<ScalarKernels<Type>, Type>();
+        return table;
+#endif
+    }
+}
+
+
+
+inline std::atomic<Isa>& isaState()
+{
+    static std::atomic<Isa> state([] {
+        Isa isa = detectedIsa();
+        Isa requested;
+        const char* name = std::getenv("VECTOR_KERNELS_ISA");
+        if (name != nullptr && parseIsa(name, requested) && requested < isa) {
+            isa = requested;
+        }
+        return isa;
+    }());
+    return state;
+}
+
+} // namespace detail
+
+
+
+template<typename Type>
+Type sum(const Type* data, std::size_t count)
+{
+    return detail::kernelTable<Type>().sum(data, count);
+}
+
+
+
+template<typename Type>
+Type dot(const Type* a, const Type* b, std::size_t count)
+{
+    return detail::kernelTable<Type>().dot(a, b, count);
+}
+
+
+
+template<typename Type>
+std::size_t argmin(const Type* data, std::size_t count)
+{
+    return count == 0 ? count : detail::kernelTable<Type>().argmin(data, count);
+}
+
+
+
+template<typename Type>
+std::size_t argmax(const Type* data, std::size_t count)
+{
+    return count == 0 ? count : detail::kernelTable<Type>().argmax(data, count);
+}
+
+
+
+template<typename Type>
+std::size_t count(const Type* data, std::size_t count, Type value)
+{
+    return detail::kernelTable<Type>().count(data, count, value);
+}
+
+
+
+template<typename Type>
+std::size_t find(const Type* data, std::size_t count, Type value)
+{
+    return detail::kernelTable<Type>().find(data, count, value);
+}
+
+
+
+template<typename Type>
+void prefixSum(const Type* data, std::size_t count, Type* out)
+{
+    detail::kernelTable<Type>().prefixSum(data, count, out);
+}
+
+
+
+template<typename Type>
+void fill(Type* data, std::size_t count, Type value)
+{
+    detail::kernelTable<Type>().fill(data, count, value);
+}
+
+
+
+template<typename Type>
+void copy(const Type* source, std::size_t count, Type* destination)
+{
+    detail::kernelTable<Type>().copy(source, count, destination);
+}
+
+
+
+inline Isa detectedIsa()
+{
+#if VECTOR_KERNELS_DISPATCH
+    static const Isa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return Isa::Avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::Avx2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+            return Isa::Sse42;
+        }
+        return Isa::Scalar;
+    }();
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+
+
+inline Isa activeIsa()
+{
+    return detail::isaState().load(std::memory_order_relaxed);
+}
+
+
+
+inline Isa setIsa(Isa isa)
+{
+    isa = std::min(isa, detectedIsa());
+    detail::isaState().store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+
+
+inline const char* isaName(Isa isa)
+{
+    switch (isa) {
+        case Isa::Sse42:
+            return "sse4.2";
+        case Isa::Avx2:
+            return "avx2";
+        case Isa::Avx512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+
+
+inline bool parseIsa(const char* name, Isa& isa)
+{
+    for (Isa candidate : {Isa::Scalar, Isa::Sse42, Isa::Avx2, Isa::Avx512}) {
+        if (std::strcmp(name, isaName(candidate)) == 0) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+template<typename Container>
+typename Container::value_type sum(const Container& v)
+{
+    return sum(v.data(), v.size());
+}
+
+
+
+template<typename Container>
+typename Container::value_type dot(const Container& a, const Container& b)
+{
+    if (a.size() != b.size()) {
+        throw "LogicError";
+    }
+    return dot(a.data(), b.data(), a.size());
+}
+
+
+
+template<typename Container>
+const typename Container::value_type& min(const Container& v)
+{
+    if (v.size() == 0) {
+        throw "LogicError";
+    }
+    return v.data()[argmin(v.data(), v.size())];
+}
+
+
+
+template<typename Container>
+const typename Container::value_type& max(const Container& v)
+{
+    if (v.size() == 0) {
+        throw "LogicError";
+    }
+    return v.data()[argmax(v.data(), v.size())];
+}
+
+
+
+template<typename Container>
+std::size_t argmin(const Container& v)
+{
+    return argmin(v.data(), v.size());
+}
+
+
+
+template<typename Container>
+std::size_t argmax(const Container& v)
+{
+    return argmax(v.data(), v.size());
+}
+
+
+
+template<typename Container>
+std::size_t count(const Container& v, const typename Container::value_type& value)
+{
+    return count(v.data(), v.size(), value);
+}
+
+
+
+template<typename Container>
+std::size_t find(const Container& v, const typename Container::value_type& value)
+{
+    return find(v.data(), v.size(), value);
+}
+
+
+
+template<typename Container>
+void prefixSum(Container& v)
+{
+    prefixSum(v.data(), v.size(), v.data());
+}
+
+} // namespace kernels
+//***************************************************************************//
+
+#endif // VECTOR_KERNELS_HPP
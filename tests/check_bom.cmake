@@ -0,0 +1,19 @@
+﻿# Проверяет, что заголовки, тесты и бенчмарки начинаются с BOM UTF-8 (комментарии в них на русском)
+file(GLOB SOURCES
+    ${ROOT}/include/*.hpp
+    ${ROOT}/tests/*.cpp
+    ${ROOT}/benchmarks/*.cpp
+)
+
+set(MISSING "")
+foreach(SOURCE ${SOURCES})
+    file(READ ${SOURCE} HEAD LIMIT 3 HEX)
+    if(NOT HEAD STREQUAL "efbbbf")
+        list(APPEND MISSING ${SOURCE})
+    endif()
+endforeach()
+
+if(MISSING)
+    string(REPLACE ";" "\n    " MISSING "${MISSING}")
+    message(FATAL_ERROR "Files without UTF-8 BOM:\n    ${MISSING}")
+endif()
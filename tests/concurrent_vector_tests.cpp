@@ -0,0 +1,105 @@
+﻿#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+
+TEST_CASE("ConcurrentVector pushBack, at and segments, int")
+{
+    ConcurrentVector<int> v1;
+    REQUIRE(v1.empty());
+    REQUIRE(v1.capacity() == 0);
+
+    REQUIRE(v1.pushBack(10) == 0);
+    int& first = v1[0];
+    for (int i = 1; i < 1000; ++i) {
+        REQUIRE(v1.pushBack(10 + i) == static_cast<std::size_t>(i));
+    }
+    REQUIRE(v1.size() == 1000);
+    REQUIRE(v1.capacity() >= 1000);
+    // Сегменты не переносятся: ссылка на первый элемент действительна
+    REQUIRE(&first == &v1[0]);
+    REQUIRE(v1[15] == 25);
+    REQUIRE(v1[16] == 26);
+    REQUIRE(v1.at(999) == 1009);
+    REQUIRE_THROWS_AS(v1.at(1000), const char*);
+
+    v1.clear();
+    REQUIRE(v1.empty());
+    v1.reserve(100);
+    REQUIRE(v1.capacity() >= 100);
+}
+
+
+
+TEST_CASE("ConcurrentVector emplaceBack, string and unique_ptr")
+{
+    ConcurrentVector<std::string> v1;
+    std::string& s = v1.emplaceBack(3, 'a');
+    v1.pushBack(std::string("b"));
+    REQUIRE(s == "aaa");
+    REQUIRE(v1[1] == "b");
+
+    ConcurrentVector<std::unique_ptr<int>> v2;
+    v2.emplaceBack(new int(5));
+    v2.pushBack(std::make_unique<int>(6));
+    REQUIRE(*v2[0] == 5);
+    REQUIRE(*v2[1] == 6);
+}
+
+
+
+TEST_CASE("ConcurrentVector stress: concurrent appends and reads")
+{
+    // Проверки Catch не потокобезопасны, поэтому потоки только собирают результаты
+    const unsigned writers = 8;
+    const std::uint64_t perWriter = 20000;
+
+    ConcurrentVector<std::uint64_t> v1;
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> badReads{0};
+
+    std::vector<std::thread> threads;
+    for (unsigned w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            for (std::uint64_t i = 0; i < perWriter; ++i) {
+                std::size_t index = v1.pushBack(w * perWriter + i);
+                if (v1[index] != w * perWriter + i) {
+                    badReads.fetch_add(1);
+                }
+            }
+        });
+    }
+    // Все элементы до size() уже созданы: читатель проверяет их через at()
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire)) {
+            std::size_t size = v1.size();
+            if (size > 0 && (v1.at(size - 1) >= writers * perWriter || v1.at(size / 2) >= writers * perWriter)) {
+                badReads.fetch_add(1);
+            }
+        }
+    });
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+
+    REQUIRE(badReads.load() == 0);
+    REQUIRE(v1.size() == writers * perWriter);
+    std::vector<std::uint64_t> values;
+    for (std::size_t i = 0; i < v1.size(); ++i) {
+        values.push_back(v1[i]);
+    }
+    std::sort(values.begin(), values.end());
+    for (std::uint64_t i = 0; i < values.size(); ++i) {
+        REQUIRE(values[i] == i);
+    }
+}
@@ -0,0 +1,205 @@
+﻿#include "catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "incremental_vector.hpp"
+
+TEST_CASE("IncrementalVector migrates old elements across pushBacks, int")
+{
+    IncrementalVector<int, std::allocator<int>, DoublingGrowth, 4> v1;
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.capacity() == 0);
+    REQUIRE_THROWS_AS(v1.at(0), const char*);
+    REQUIRE_THROWS_AS(v1.popBack(), const char*);
+
+    v1.reserve(64);
+    for (int i = 0; i < 64; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.migrating() == false);
+
+    // Рост: элементы остаются в старом буфере и переносятся по 4 за pushBack
+    v1.pushBack(64);
+    REQUIRE(v1.capacity() == 128);
+    REQUIRE(v1.migrating() == true);
+    for (int i = 0; i < 65; ++i) {
+        REQUIRE(v1[i] == i);
+    }
+    for (int i = 65; i < 79; ++i) {
+        v1.pushBack(i);
+        REQUIRE(v1.migrating() == true);
+    }
+    v1.pushBack(79);
+    REQUIRE(v1.migrating() == false);
+    for (int i = 0; i < 80; ++i) {
+        REQUIRE(v1.at(i) == i);
+    }
+    REQUIRE(v1.back() == 79);
+}
+
+
+
+TEST_CASE("IncrementalVector popBack and finishMigration during migration, int")
+{
+    IncrementalVector<int, std::allocator<int>, DoublingGrowth, 2> v1;
+    for (int i = 0; i < 33; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.migrating() == true);
+
+    // Удаление элементов, ещё лежащих в старом буфере, сокращает перенос
+    while (v1.size() > 10) {
+        v1.popBack();
+    }
+    REQUIRE(v1.migrating() == true);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(v1[i] == i);
+    }
+    while (v1.size() > 2) {
+        v1.popBack();
+    }
+    REQUIRE(v1.migrating() == false);
+    REQUIRE(v1.back() == 1);
+
+    for (int i = 2; i < 65; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.migrating() == true);
+    v1.finishMigration();
+    REQUIRE(v1.migrating() == false);
+    for (int i = 0; i < 65; ++i) {
+        REQUIRE(v1[i] == i);
+    }
+
+    // Добавление ссылки на собственный элемент старого буфера в момент роста
+    while (v1.size() != v1.capacity()) {
+        v1.pushBack(0);
+    }
+    v1.pushBack(v1[3]);
+    REQUIRE(v1.back() == 3);
+}
+
+
+
+namespace
+{
+    // Рост на два элемента: перенос по одному не успевает закончиться до следующего роста
+    struct SlowGrowth
+    {
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t, std::size_t)
+        {
+            return std::max(capacity + 2, required);
+        }
+
+        static std::size_t shrink(std::size_t, std::size_t count, std::size_t)
+        {
+            return count;
+        }
+    };
+}
+
+
+
+TEST_CASE("IncrementalVector emplaceBack of own element while growth overtakes migration, string")
+{
+    IncrementalVector<std::string, std::allocator<std::string>, SlowGrowth, 1> v1;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 40; ++i) {
+        std::string element = "element number " + std::to_string(i) + " outside of SSO";
+        v1.pushBack(element);
+        expected.push_back(element);
+    }
+
+    // Каждый рост заканчивает предыдущий перенос; v1[size - 3] ещё лежит в старом буфере
+    for (int i = 0; i < 20; ++i) {
+        while (v1.size() != v1.capacity()) {
+            v1.emplaceBack(v1[0]);
+            expected.push_back(expected[0]);
+        }
+        REQUIRE(v1.migrating() == true);
+        std::size_t index = v1.size() - 3;
+        v1.emplaceBack(v1[index]);
+        expected.push_back(expected[index]);
+    }
+
+    REQUIRE(v1.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(v1[i] == expected[i]);
+    }
+}
+
+
+
+TEST_CASE("IncrementalVector copy, move and clear, string and unique_ptr")
+{
+    IncrementalVector<std::string> v1;
+    for (int i = 0; i < 66; ++i) {
+        v1.pushBack(std::to_string(i));
+    }
+    REQUIRE(v1.migrating() == true);
+
+    IncrementalVector<std::string> v2(v1);
+    REQUIRE(v2.size() == 66);
+    REQUIRE(v2.migrating() == false);
+    REQUIRE(v2[65] == "65");
+
+    IncrementalVector<std::string> v3(std::move(v1));
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v3[50] == "50");
+    v1 = v3;
+    REQUIRE(v1[0] == "0");
+    v2 = std::move(v3);
+    REQUIRE(v2.size() == 66);
+
+    v2.clear();
+    REQUIRE(v2.empty());
+    REQUIRE(v2.capacity() == 0);
+
+    IncrementalVector<std::unique_ptr<int>> v4;
+    for (int i = 0; i < 100; ++i) {
+        v4.emplaceBack(new int(i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(*v4[i] == i);
+    }
+}
+
+
+
+TEST_CASE("IncrementalVector on polymorphic_allocator keeps its arena on assignment, string")
+{
+    using Arena = std::pmr::polymorphic_allocator<std::string>;
+    using Incremental = IncrementalVector<std::string, Arena>;
+
+    MonotonicArena arena1;
+    MonotonicArena arena2;
+    Incremental v1{Arena(&arena1)};
+    for (int i = 0; i < 33; ++i) {
+        v1.pushBack(std::to_string(i));
+    }
+    REQUIRE(v1.migrating() == true);
+
+    // propagate_on_container_copy_assignment и _swap - false: буфер остаётся в arena2
+    Incremental v2{Arena(&arena2)};
+    v2.pushBack("x");
+    v2 = v1;
+    REQUIRE(v2.getAllocator().resource() == &arena2);
+    REQUIRE(v2.size() == 33);
+    REQUIRE(v2[32] == "32");
+
+    Incremental v3{Arena(&arena2)};
+    v3 = std::move(v1);
+    REQUIRE(v3.getAllocator().resource() == &arena2);
+    REQUIRE(v3.size() == 33);
+    REQUIRE(v3[0] == "0");
+    REQUIRE(v1.empty());
+
+    Incremental v4(v3, Arena(&arena1));
+    REQUIRE(v4.getAllocator().resource() == &arena1);
+    REQUIRE(v4[10] == "10");
+}
@@ -0,0 +1,147 @@
+﻿#include "catch.hpp"
+
+#include <algorithm>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include "stable_vector.hpp"
+
+TEST_CASE("StableVector init, int")
+{
+    StableVector<int> v1;
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.capacity() == 0);
+    REQUIRE(v1.empty() == true);
+    REQUIRE(StableVector<int>::chunkSize == 16384);
+    REQUIRE(StableVector<int, 100>::chunkSize == 16);
+    REQUIRE_THROWS_AS(v1.at(0), const char*);
+    REQUIRE_THROWS_AS(v1.popBack(), const char*);
+}
+
+
+
+TEST_CASE("StableVector pushBack keeps element addresses, int")
+{
+    StableVector<int, 64> v1;
+    REQUIRE(v1.chunkSize == 16);
+
+    v1.pushBack(0);
+    int* first = &v1[0];
+    int* twentieth = nullptr;
+    for (int i = 1; i < 1000; ++i) {
+        v1.pushBack(i);
+        if (i == 20) {
+            twentieth = &v1[20];
+        }
+    }
+    REQUIRE(v1.size() == 1000);
+    REQUIRE(v1.capacity() == 1008);
+    REQUIRE(v1.chunkCount() == 63);
+    REQUIRE(&v1[0] == first);
+    REQUIRE(&v1[20] == twentieth);
+    REQUIRE(*twentieth == 20);
+    REQUIRE(v1.at(999) == 999);
+    REQUIRE(v1.front() == 0);
+    REQUIRE(v1.back() == 999);
+    REQUIRE_THROWS_AS(v1.at(1000), const char*);
+
+    // Добавление ссылки на собственный элемент на границе блока
+    while (v1.size() != v1.capacity()) {
+        v1.pushBack(v1[v1.size() - 1]);
+    }
+    v1.pushBack(v1[5]);
+    REQUIRE(v1.back() == 5);
+
+    v1.popBack();
+    REQUIRE(v1.back() == 999);
+    REQUIRE(v1.chunk(1)[0] == 16);
+}
+
+
+
+TEST_CASE("StableVector iterators and standard algorithms, int")
+{
+    StableVector<int, 64> v1;
+    for (int i = 0; i < 100; ++i) {
+        v1.pushBack(99 - i);
+    }
+    std::sort(v1.begin(), v1.end());
+    REQUIRE(std::is_sorted(v1.begin(), v1.end()));
+    REQUIRE(v1[0] == 0);
+    REQUIRE(v1.end() - v1.begin() == 100);
+    REQUIRE(std::accumulate(v1.begin(), v1.end(), 0) == 4950);
+
+    const StableVector<int, 64>& c1 = v1;
+    StableVector<int, 64>::const_iterator it = v1.begin();
+    REQUIRE(it == c1.begin());
+    REQUIRE(*(c1.end() - 1) == 99);
+    REQUIRE(std::find(c1.begin(), c1.end(), 42) - c1.begin() == 42);
+}
+
+
+
+TEST_CASE("StableVector copy, move and clear, string")
+{
+    StableVector<std::string, 128> v1;
+    for (int i = 0; i < 50; ++i) {
+        v1.emplaceBack(std::to_string(i));
+    }
+    StableVector<std::string, 128> v2(v1);
+    REQUIRE(v2.size() == 50);
+    REQUIRE(v2[49] == "49");
+
+    std::string* moved = &v1[10];
+    StableVector<std::string, 128> v3(std::move(v1));
+    REQUIRE(v1.size() == 0);
+    REQUIRE(&v3[10] == moved);
+
+    v1 = v3;
+    REQUIRE(v1.size() == 50);
+    v2 = std::move(v3);
+    REQUIRE(v2[10] == "10");
+    REQUIRE(&v2[10] == moved);
+
+    v2.clear();
+    REQUIRE(v2.empty());
+    REQUIRE(v2.capacity() == 0);
+    v2.reserve(100);
+    REQUIRE(v2.capacity() >= 100);
+    v2.pushBack("x");
+    REQUIRE(v2.back() == "x");
+}
+
+
+
+TEST_CASE("StableVector on polymorphic_allocator keeps its arena on assignment, string")
+{
+    using Arena = std::pmr::polymorphic_allocator<std::string>;
+    using Stable = StableVector<std::string, 128, Arena>;
+
+    MonotonicArena arena1;
+    MonotonicArena arena2;
+    Stable v1{Arena(&arena1)};
+    for (int i = 0; i < 20; ++i) {
+        v1.pushBack(std::to_string(i));
+    }
+
+    // propagate_on_container_copy_assignment и _swap - false: блоки остаются в arena2
+    Stable v2{Arena(&arena2)};
+    v2.pushBack("x");
+    v2 = v1;
+    REQUIRE(v2.getAllocator().resource() == &arena2);
+    REQUIRE(v2.size() == 20);
+    REQUIRE(v2[19] == "19");
+
+    Stable v3{Arena(&arena2)};
+    v3 = std::move(v1);
+    REQUIRE(v3.getAllocator().resource() == &arena2);
+    REQUIRE(v3.size() == 20);
+    REQUIRE(v3[0] == "0");
+    REQUIRE(v1.empty());
+
+    Stable v4(v3, Arena(&arena1));
+    REQUIRE(v4.getAllocator().resource() == &arena1);
+    REQUIRE(v4[10] == "10");
+}
@@ -0,0 +1,153 @@
+﻿#include "catch.hpp"
+
+#include <string>
+
+#include "static_vector.hpp"
+
+TEST_CASE("StaticVector init, int")
+{
+    StaticVector<int, 8> v1;
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.capacity() == 8);
+    REQUIRE(v1.empty() == true);
+}
+
+
+
+TEST_CASE("StaticVector pushBack, int")
+{
+    StaticVector<int, 3> v1;
+    v1.pushBack(888);
+    REQUIRE(v1.size() == 1);
+    REQUIRE(v1.empty() == false);
+
+    v1.pushBack(999);
+    v1.pushBack(3);
+    REQUIRE(v1.size() == 3);
+    REQUIRE(v1.capacity() == 3);
+
+    REQUIRE_THROWS(v1.pushBack(4));
+    REQUIRE(v1.size() == 3);
+}
+
+
+
+TEST_CASE("StaticVector popBack, int")
+{
+    StaticVector<int, 4> v1;
+    v1.pushBack(888);
+    v1.popBack();
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.empty() == true);
+    REQUIRE_THROWS(v1.popBack());
+
+    v1.pushBack(2000);
+    v1.pushBack(2001);
+    v1.popBack();
+    REQUIRE(v1.size() == 1);
+    REQUIRE(v1.back() == 2000);
+}
+
+
+
+TEST_CASE("StaticVector at, back, front, operator[], int")
+{
+    StaticVector<int, 4> v1;
+    v1.pushBack(888);
+    v1.pushBack(999);
+    REQUIRE(v1.at(0) == 888);
+    REQUIRE(v1.front() == 888);
+    REQUIRE(v1.at(1) == 999);
+    REQUIRE(v1.back() == 999);
+    REQUIRE(v1[0] == 888);
+    REQUIRE(v1[1] == 999);
+    REQUIRE_THROWS(v1.at(2));
+}
+
+
+
+TEST_CASE("StaticVector assign, resize, clear, int")
+{
+    StaticVector<int, 16> v1;
+    v1.assign(3, 5);
+    REQUIRE(v1.size() == 3);
+    REQUIRE(v1[2] == 5);
+
+    v1.resize(9);
+    REQUIRE(v1.size() == 9);
+    REQUIRE(v1[2] == 5);
+    REQUIRE(v1[8] == 0);
+
+    v1.resize(2);
+    REQUIRE(v1.size() == 2);
+    REQUIRE_THROWS(v1.resize(17));
+    REQUIRE_THROWS(v1.reserve(17));
+
+    v1.clear();
+    REQUIRE(v1.empty() == true);
+    REQUIRE(v1.capacity() == 16);
+}
+
+
+
+TEST_CASE("StaticVector copy and move, string")
+{
+    StaticVector<std::string, 4> v1;
+    v1.pushBack("a");
+    v1.emplaceBack(3, 'b');
+
+    StaticVector<std::string, 4> v2(v1);
+    REQUIRE(v2.size() == 2);
+    REQUIRE(v2[1] == "bbb");
+
+    StaticVector<std::string, 4> v3(std::move(v1));
+    REQUIRE(v3.size() == 2);
+    REQUIRE(v3[0] == "a");
+
+    v2.popBack();
+    v3 = v2;
+    REQUIRE(v3.size() == 1);
+    REQUIRE(v3.back() == "a");
+}
+
+
+
+namespace
+{
+    constexpr int staticVectorSum()
+    {
+        StaticVector<int, 8> v(constexprInit);
+        v.pushBack(1);
+        v.pushBack(2);
+        v.emplaceBack(3);
+        v.popBack();
+        v.resize(4);
+        v[3] = 10;
+        return v[0] + v[1] + v.at(3) + static_cast<int>(v.size());
+    }
+
+#if defined(__cpp_lib_is_constant_evaluated)
+    // Начиная с C++20 стандартный конструктор тоже годится для константного вычисления
+    constexpr int staticVectorDefaultSum()
+    {
+        StaticVector<int, 8> v;
+        v.pushBack(1);
+        v.pushBack(2);
+        return v[0] + v[1];
+    }
+#endif
+}
+
+
+
+TEST_CASE("StaticVector in constexpr context")
+{
+    static_assert(staticVectorSum() == 17, "");
+#if defined(__cpp_lib_is_constant_evaluated)
+    static_assert(staticVectorDefaultSum() == 3, "");
+#endif
+
+    StaticVector<int, 2, UncheckedOverflow> v1;
+    v1.pushBack(1);
+    REQUIRE(v1.size() == 1);
+}
@@ -1,7 +1,31 @@
 ﻿#define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#include <span>
+#endif
+
+#include "allocators.hpp"
+#include "claim_writer.hpp"
+#include "parallel.hpp"
+#include "thread_local_vector.hpp"
 #include "vector.hpp"
+#include "vector_expressions.hpp"
+#include "vector_kernels.hpp"
 
 TEST_CASE("Vector init, int")
 {
@@ -303,3 +327,1165 @@ TEST_CASE("Vector shrinkToFit, int")
     REQUIRE(v1.size() == 4);
     REQUIRE(v1.capacity() == 4);
 }
+
+
+
+namespace
+{
+    struct Counted
+    {
+        static int constructed;
+        static int destroyed;
+
+        Counted() { ++constructed; }
+        Counted(const Counted&) { ++constructed; }
+        ~Counted() { ++destroyed; }
+        Counted& operator=(const Counted&) = default;
+
+        static void reset()
+        {
+            constructed = 0;
+            destroyed = 0;
+        }
+    };
+
+    int Counted::constructed = 0;
+    int Counted::destroyed = 0;
+}
+
+
+
+TEST_CASE("Vector reserve does not construct elements")
+{
+    Counted::reset();
+    {
+        Vector<Counted> v1;
+        v1.reserve(1000);
+        REQUIRE(v1.capacity() >= 1000);
+        REQUIRE(Counted::constructed == 0);
+
+        v1.resize(3);
+        REQUIRE(Counted::constructed == 3);
+
+        v1.popBack();
+        REQUIRE(Counted::destroyed == 1);
+    }
+    REQUIRE(Counted::constructed == Counted::destroyed);
+}
+
+
+
+TEST_CASE("Vector pushBack of own element while growing, int")
+{
+    Vector<int> v1;
+    v1.pushBack(7);
+    for (int i = 0; i < 10; ++i) {
+        v1.pushBack(v1[0]);
+    }
+    REQUIRE(v1.size() == 11);
+    REQUIRE(v1.back() == 7);
+}
+
+
+
+namespace
+{
+    template<bool NoexceptMove>
+    struct Relocated
+    {
+        static int copies;
+        static int moves;
+
+        Relocated() = default;
+        Relocated(const Relocated&) { ++copies; }
+        Relocated(Relocated&&) noexcept(NoexceptMove) { ++moves; }
+    };
+
+    template<bool NoexceptMove>
+    int Relocated<NoexceptMove>::copies = 0;
+
+    template<bool NoexceptMove>
+    int Relocated<NoexceptMove>::moves = 0;
+}
+
+
+
+TEST_CASE("Vector reserve moves noexcept-movable elements")
+{
+    using Movable = Relocated<true>;
+    using Copyable = Relocated<false>;
+
+    Vector<Movable> v1;
+    v1.resize(4);
+    v1.reserve(100);
+    REQUIRE(Movable::moves == 4);
+    REQUIRE(Movable::copies == 0);
+
+    Vector<Copyable> v2;
+    v2.resize(4);
+    v2.reserve(100);
+    REQUIRE(Copyable::moves == 0);
+    REQUIRE(Copyable::copies == 4);
+}
+
+
+
+TEST_CASE("Vector of Vector and SmallVector moves nested elements on growth")
+{
+    static_assert(std::is_nothrow_move_constructible<Vector<int>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<Vector<int>>::value, "");
+    static_assert(std::is_nothrow_move_constructible<SmallVector<int, 4>>::value, "");
+    static_assert(std::is_nothrow_move_constructible<SmallVector<Vector<int>, 4>>::value, "");
+
+    // Элементы внутри копируются, но не перемещаются без исключений - рост внешнего вектора не должен их трогать
+    using Copyable = Relocated<false>;
+    Copyable::copies = 0;
+
+    Vector<Vector<Copyable>> v1;
+    Vector<SmallVector<Vector<Copyable>, 2>> v2;
+    for (int i = 0; i < 100; ++i) {
+        v1.emplaceBack().resize(3);
+        v2.emplaceBack().emplaceBack().resize(3);
+    }
+    REQUIRE(v1.size() == 100);
+    REQUIRE(v2.size() == 100);
+    REQUIRE(Copyable::copies == 0);
+}
+
+
+
+TEST_CASE("Vector of trivially relocatable unique_ptr")
+{
+    static_assert(isTriviallyRelocatable<int>, "");
+    static_assert(isTriviallyRelocatable<std::unique_ptr<int>>, "");
+    static_assert(!isTriviallyRelocatable<Counted>, "");
+
+    Vector<std::unique_ptr<int>> v1;
+    for (int i = 0; i < 100; ++i) {
+        v1.resize(i + 1);
+        v1[i].reset(new int(i));
+    }
+    v1.resize(50);
+    v1.shrinkToFit();
+    REQUIRE(v1.size() == 50);
+    REQUIRE(v1.capacity() == 64);
+    for (int i = 0; i < 50; ++i) {
+        REQUIRE(*v1[i] == i);
+    }
+}
+
+
+
+TEST_CASE("Vector assign and copy, trivially copyable")
+{
+    Vector<char> v1;
+    v1.assign(100, 'a');
+    REQUIRE(v1.size() == 100);
+    REQUIRE(v1[99] == 'a');
+
+    Vector<double> v2;
+    v2.assign(10, 1.5);
+    v2.assign(5, 0.0);
+    REQUIRE(v2.size() == 10);
+    REQUIRE(v2[4] == 0.0);
+    REQUIRE(v2[5] == 1.5);
+
+    Vector<double> v3(v2);
+    REQUIRE(v3.size() == 10);
+    REQUIRE(v3[0] == 0.0);
+    REQUIRE(v3[9] == 1.5);
+}
+
+
+
+TEST_CASE("Vector with MallocAllocator grows through realloc and mremap")
+{
+    using Allocator = MallocAllocator<std::uint64_t, 4096>;
+
+    Vector<std::uint64_t, Allocator> v1;
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.size() == 100000);
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        REQUIRE(v1[i] == i);
+    }
+
+    v1.resize(100);
+    v1.shrinkToFit();
+    REQUIRE(v1.capacity() == 128);
+    REQUIRE(v1[99] == 99);
+
+    Vector<std::uint64_t, Allocator> v2(v1);
+    REQUIRE(v2.size() == 100);
+    REQUIRE(v2[0] == 0);
+}
+
+
+
+TEST_CASE("Vector growth policies")
+{
+    REQUIRE(DoublingGrowth::grow(4, 5, 1000, 4) == 8);
+    REQUIRE(DoublingGrowth::grow(4, 17, 1000, 4) == 32);
+    REQUIRE(DoublingGrowth::grow(600, 601, 1000, 4) == 1000);
+    REQUIRE(DoublingGrowth::shrink(16, 4, 4) == 4);
+
+    REQUIRE(GoldenGrowth::grow(4, 5, 1000, 4) == 6);
+    REQUIRE(GoldenGrowth::grow(4, 20, 1000, 4) == 20);
+    REQUIRE(GoldenGrowth::shrink(16, 5, 4) == 5);
+
+    REQUIRE(SizeClassGrowth<>::grow(4, 5, 1000, 4) >= 8);
+    REQUIRE(PageGranularGrowth<1>::grow(1024 * 1024, 1024 * 1024 + 1, std::size_t(-1), 1) % 4096 == 0);
+
+    Vector<int, std::allocator<int>, GoldenGrowth> v1;
+    for (int i = 0; i < 1000; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.size() == 1000);
+    REQUIRE(v1[999] == 999);
+    v1.resize(10);
+    v1.shrinkToFit();
+    REQUIRE(v1.capacity() == 10);
+
+    Vector<int, std::allocator<int>, SizeClassGrowth<GoldenGrowth>> v2;
+    for (int i = 0; i < 1000; ++i) {
+        v2.pushBack(i);
+    }
+    REQUIRE(v2.size() == 1000);
+    REQUIRE(v2[999] == 999);
+}
+
+
+
+TEST_CASE("SmallVector stays inline up to N, int")
+{
+    SmallVector<int, 4> v1;
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.capacity() == 4);
+    REQUIRE(v1.isInline() == true);
+
+    for (int i = 0; i < 4; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1.isInline() == true);
+    REQUIRE(v1.back() == 3);
+
+    v1.pushBack(4);
+    REQUIRE(v1.isInline() == false);
+    REQUIRE(v1.size() == 5);
+    REQUIRE(v1.capacity() >= 5);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(v1.at(i) == i);
+    }
+
+    v1.resize(3);
+    v1.shrinkToFit();
+    REQUIRE(v1.isInline() == true);
+    REQUIRE(v1.capacity() == 4);
+    REQUIRE(v1[2] == 2);
+
+    v1.clear();
+    REQUIRE(v1.empty() == true);
+    REQUIRE(v1.isInline() == true);
+}
+
+
+
+TEST_CASE("SmallVector copy and move, string")
+{
+    SmallVector<std::string, 2> v1;
+    v1.pushBack("a");
+    v1.emplaceBack(3, 'b');
+
+    SmallVector<std::string, 2> v2(v1);
+    REQUIRE(v2.size() == 2);
+    REQUIRE(v2[1] == "bbb");
+
+    SmallVector<std::string, 2> v3(std::move(v1));
+    REQUIRE(v3.size() == 2);
+    REQUIRE(v3[0] == "a");
+    REQUIRE(v1.empty() == true);
+
+    v3.pushBack("c");
+    REQUIRE(v3.isInline() == false);
+    SmallVector<std::string, 2> v4;
+    v4 = std::move(v3);
+    REQUIRE(v4.size() == 3);
+    REQUIRE(v4[2] == "c");
+    REQUIRE(v3.isInline() == true);
+
+    v2 = v4;
+    REQUIRE(v2.size() == 3);
+    REQUIRE(v2.front() == "a");
+}
+
+
+
+TEST_CASE("SmallVector does not leak")
+{
+    Counted::reset();
+    {
+        SmallVector<Counted, 2> v1;
+        v1.resize(2);
+        v1.resize(10);
+        v1.popBack();
+        SmallVector<Counted, 2> v2(v1);
+        v1.resize(1);
+        v1.shrinkToFit();
+        v2 = std::move(v1);
+    }
+    REQUIRE(Counted::constructed == Counted::destroyed);
+}
+
+
+
+namespace
+{
+    // Один и тот же код для Vector и SmallVector: последние элементы в обратном порядке
+    template<typename Container>
+    std::string reversedTail(const Container& v, std::size_t count)
+    {
+        std::string result;
+        for (auto it = v.rbegin(); it != v.rend() && count > 0; ++it, --count) {
+            result += std::to_string(*it);
+        }
+        return result + ":" + std::to_string(std::accumulate(v.cbegin(), v.cend(), 0));
+    }
+}
+
+
+
+TEST_CASE("SmallVector iterators match Vector, int")
+{
+    Vector<int> v1;
+    SmallVector<int, 4> v2;
+    for (int i = 1; i <= 3; ++i) {
+        v1.pushBack(i);
+        v2.pushBack(i);
+    }
+    REQUIRE(v2.isInline() == true);
+    REQUIRE(reversedTail(v2, 2) == reversedTail(v1, 2));
+    REQUIRE(reversedTail(v2, 2) == "32:6");
+
+    for (int i = 4; i <= 9; ++i) {
+        v1.pushBack(i);
+        v2.pushBack(i);
+    }
+    REQUIRE(v2.isInline() == false);
+    REQUIRE(reversedTail(v2, 3) == reversedTail(v1, 3));
+
+    std::sort(v2.rbegin(), v2.rend());
+    REQUIRE(v2.front() == 9);
+    const SmallVector<int, 4>& c2 = v2;
+    REQUIRE(*c2.rbegin() == 1);
+    REQUIRE(c2.rend() - c2.rbegin() == 9);
+}
+
+
+
+TEST_CASE("pmr::Vector grows in place at the top of MonotonicArena")
+{
+    MonotonicArena arena(1024 * 1024);
+    pmr::Vector<int> v1(&arena);
+    v1.pushBack(1);
+    const int* first = &v1[0];
+    for (int i = 2; i <= 1000; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(&v1[0] == first);
+    REQUIRE(v1.size() == 1000);
+    REQUIRE(v1.back() == 1000);
+    REQUIRE(arena.reservedBytes() == 1024 * 1024);
+
+    pmr::Vector<int> v2(&arena);
+    v2.pushBack(5);
+    v1.reserve(100000);
+    REQUIRE(v1[999] == 1000);
+    REQUIRE(v2[0] == 5);
+}
+
+
+
+TEST_CASE("pmr::Vector copy and move between arenas, string")
+{
+    MonotonicArena arena1;
+    MonotonicArena arena2;
+    pmr::Vector<std::string> v1(&arena1);
+    v1.pushBack("a");
+    v1.pushBack("b");
+
+    pmr::Vector<std::string> v2(&arena2);
+    v2 = v1;
+    REQUIRE(v2.getAllocator().resource() == &arena2);
+    REQUIRE(v2.size() == 2);
+    REQUIRE(v2[1] == "b");
+
+    pmr::Vector<std::string> v3(&arena2);
+    v3 = std::move(v1);
+    REQUIRE(v3.getAllocator().resource() == &arena2);
+    REQUIRE(v3.size() == 2);
+    REQUIRE(v3[0] == "a");
+    REQUIRE(v1.empty() == true);
+
+    pmr::Vector<std::string> v4(std::move(v3));
+    REQUIRE(v4.getAllocator().resource() == &arena2);
+    REQUIRE(v4.size() == 2);
+
+    arena1.release();
+    REQUIRE(arena1.reservedBytes() == 0);
+}
+
+
+
+TEST_CASE("Vector with AlignedAllocator and HugePageAllocator")
+{
+    Vector<float, AlignedAllocator<float, 64>> v1;
+    for (int i = 0; i < 1000; ++i) {
+        v1.pushBack(static_cast<float>(i));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(&v1[0]) % 64 == 0);
+    }
+    REQUIRE(v1[999] == 999.0f);
+
+    Vector<float, HugePageAllocator<float, 64 * 1024>> v2;
+    v2.resize(1024 * 1024);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&v2[0]) % (2 * 1024 * 1024) == 0);
+    v2[1024 * 1024 - 1] = 1.0f;
+    v2.pushBack(2.0f);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&v2[0]) % (2 * 1024 * 1024) == 0);
+    REQUIRE(v2[1024 * 1024 - 1] == 1.0f);
+    REQUIRE(v2.back() == 2.0f);
+
+    v2.resize(10);
+    v2.shrinkToFit();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(&v2[0]) % 64 == 0);
+}
+
+
+
+namespace
+{
+    struct Emplaced
+    {
+        static int constructed;
+        static int copied;
+        static int moved;
+
+        Emplaced(int a, int b) : sum(a + b) { ++constructed; }
+        Emplaced(const Emplaced& other) : sum(other.sum) { ++copied; }
+        Emplaced(Emplaced&& other) noexcept : sum(other.sum) { ++moved; }
+
+        static void reset()
+        {
+            constructed = 0;
+            copied = 0;
+            moved = 0;
+        }
+
+        int sum;
+    };
+
+    int Emplaced::constructed = 0;
+    int Emplaced::copied = 0;
+    int Emplaced::moved = 0;
+}
+
+
+
+TEST_CASE("Vector emplaceBack constructs in place")
+{
+    Vector<Emplaced> v1;
+    v1.reserve(10);
+    Emplaced::reset();
+
+    Emplaced& last = v1.emplaceBack(1, 2);
+    REQUIRE(Emplaced::constructed == 1);
+    REQUIRE(Emplaced::copied == 0);
+    REQUIRE(Emplaced::moved == 0);
+    REQUIRE(&last == &v1[0]);
+    REQUIRE(last.sum == 3);
+
+    for (int i = 0; i < 9; ++i) {
+        v1.emplaceBack(i, i);
+    }
+    REQUIRE(Emplaced::constructed == 10);
+    REQUIRE(Emplaced::copied == 0);
+    REQUIRE(Emplaced::moved == 0);
+
+    v1.pushBack(Emplaced(2, 2));
+    REQUIRE(Emplaced::copied == 0);
+    REQUIRE(v1.back().sum == 4);
+
+    Vector<std::unique_ptr<int>> v2;
+    for (int i = 0; i < 10; ++i) {
+        v2.emplaceBack(new int(i));
+    }
+    v2.pushBack(std::make_unique<int>(10));
+    REQUIRE(*v2[10] == 10);
+
+    Vector<std::string> v3;
+    v3.pushBack("abc");
+    for (int i = 0; i < 10; ++i) {
+        v3.emplaceBack(v3[0]);
+    }
+    REQUIRE(v3.back() == "abc");
+}
+
+
+
+TEST_CASE("Vector initializer list, append and insert, int")
+{
+    Vector<int> v1{1, 2, 3};
+    REQUIRE(v1.size() == 3);
+    REQUIRE(v1.capacity() == 3);
+    REQUIRE(v1[2] == 3);
+
+    const int chunk[] = {4, 5, 6, 7};
+    v1.append(chunk, 4);
+    REQUIRE(v1.size() == 7);
+    REQUIRE(v1[6] == 7);
+
+    v1.append(&v1[0], v1.size());
+    REQUIRE(v1.size() == 14);
+    REQUIRE(v1[7] == 1);
+    REQUIRE(v1[13] == 7);
+
+    std::list<int> source{8, 9};
+    v1.append(source.begin(), source.end());
+    REQUIRE(v1.size() == 16);
+    REQUIRE(v1.back() == 9);
+
+    const int middle[] = {2, 3, 4};
+    Vector<int> v2{1, 5};
+    v2.insert(1, middle, middle + 3);
+    REQUIRE(v2.size() == 5);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(v2[i] == i + 1);
+    }
+    v2.insert(5, source.begin(), source.end());
+    REQUIRE(v2.back() == 9);
+    REQUIRE_THROWS(v2.insert(8, chunk, chunk + 1));
+}
+
+
+
+TEST_CASE("Vector append and insert, string")
+{
+    Vector<std::string> v1{"a", "d"};
+    std::string middle[] = {"b", "c"};
+    v1.insert(1, middle, middle + 2);
+    REQUIRE(v1.size() == 4);
+    REQUIRE(v1[1] == "b");
+    REQUIRE(v1[2] == "c");
+    REQUIRE(v1[3] == "d");
+
+    std::istringstream input("e f");
+    v1.append(std::istream_iterator<std::string>(input), std::istream_iterator<std::string>());
+    REQUIRE(v1.size() == 6);
+    REQUIRE(v1.back() == "f");
+
+    v1.append(&v1[0], 2);
+    REQUIRE(v1.size() == 8);
+    REQUIRE(v1[7] == "b");
+}
+
+
+
+TEST_CASE("Vector resizeDefaultInit and growForOverwrite, uint8_t")
+{
+    Vector<std::uint8_t> v1;
+    v1.resizeDefaultInit(16);
+    REQUIRE(v1.size() == 16);
+    REQUIRE(v1.capacity() >= 16);
+    v1.assign(16, 7);
+
+    const char message[] = "hello";
+    std::uint8_t* tail = v1.growForOverwrite(5);
+    std::memcpy(tail, message, 5);
+    REQUIRE(v1.size() == 21);
+    REQUIRE(v1[15] == 7);
+    REQUIRE(v1[16] == 'h');
+    REQUIRE(v1.back() == 'o');
+
+    v1.resizeDefaultInit(4);
+    REQUIRE(v1.size() == 4);
+    REQUIRE(v1[3] == 7);
+
+    Vector<std::string> v2;
+    v2.resizeDefaultInit(3);
+    REQUIRE(v2.size() == 3);
+    REQUIRE(v2[2].empty() == true);
+}
+
+
+
+TEST_CASE("Vector with MallocAllocator takes zeroed memory for resize and assign")
+{
+    using Allocator = MallocAllocator<double, 64 * 1024>;
+
+    Vector<double, Allocator> v1;
+    v1.pushBack(1.5);
+    v1.resize(100000);
+    REQUIRE(v1.size() == 100000);
+    REQUIRE(v1[0] == 1.5);
+    for (std::size_t i = 1; i < v1.size(); i += 997) {
+        REQUIRE(v1[i] == 0.0);
+    }
+    REQUIRE(v1.back() == 0.0);
+
+    Vector<double, Allocator> v2;
+    v2.assign(3, 2.0);
+    v2.assign(50, 0.0);
+    REQUIRE(v2.size() == 50);
+    REQUIRE(v2[0] == 0.0);
+    REQUIRE(v2[49] == 0.0);
+
+    v2.assign(10, -0.0);
+    REQUIRE(v2.size() == 50);
+    REQUIRE(std::signbit(v2[0]) == true);
+
+    // Рост заполненного вектора идёт через reallocate: префикс сохраняется, хвост - нули
+    Vector<double, MallocAllocator<double>> v3;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        v3.pushBack(static_cast<double>(i) + 0.5);
+    }
+    v3.resize(300000);
+    REQUIRE(v3.size() == 300000);
+    bool prefixKept = true;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        prefixKept = prefixKept && v3[i] == static_cast<double>(i) + 0.5;
+    }
+    REQUIRE(prefixKept);
+    REQUIRE(std::count(v3.begin() + 100000, v3.end(), 0.0) == 200000);
+}
+
+
+
+TEST_CASE("Vector iterators and standard algorithms, int")
+{
+    Vector<int> v1{5, 3, 9, 1, 7};
+    std::sort(v1.begin(), v1.end());
+    REQUIRE(std::is_sorted(v1.cbegin(), v1.cend()) == true);
+    REQUIRE(v1.data() == &v1[0]);
+    REQUIRE(v1.end() - v1.begin() == 5);
+
+    int sum = 0;
+    for (int value : v1) {
+        sum += value;
+    }
+    REQUIRE(sum == 25);
+    REQUIRE(std::accumulate(v1.begin(), v1.end(), 0) == 25);
+
+    Vector<int> v2;
+    v2.append(v1.rbegin(), v1.rend());
+    REQUIRE(v2[0] == 9);
+    REQUIRE(v2[4] == 1);
+
+    const Vector<int>& v3 = v2;
+    REQUIRE(*v3.rbegin() == 1);
+    REQUIRE(std::find(v3.begin(), v3.end(), 3) - v3.begin() == 3);
+
+    Vector<int> empty;
+    REQUIRE(empty.begin() == empty.end());
+
+    SmallVector<int, 4> v4;
+    v4.pushBack(2);
+    v4.pushBack(1);
+    std::sort(v4.begin(), v4.end());
+    REQUIRE(*v4.data() == 1);
+
+#if defined(__cpp_lib_ranges)
+    static_assert(std::ranges::contiguous_range<Vector<int>>);
+    static_assert(std::ranges::sized_range<Vector<int>>);
+    std::span<const int> span(v1);
+    REQUIRE(span.size() == 5);
+#endif
+}
+
+
+
+TEST_CASE("Vector insert, emplace and erase at positions, int")
+{
+    Vector<int> v1{1, 2, 4};
+    v1.insert(2, 3);
+    v1.insert(0, 0);
+    int& last = v1.emplace(5, 5);
+    REQUIRE(last == 5);
+    REQUIRE(v1.size() == 6);
+    for (int i = 0; i < 6; ++i) {
+        REQUIRE(v1[i] == i);
+    }
+    REQUIRE_THROWS(v1.insert(7, 1));
+
+    v1.insert(1, v1[5]);
+    REQUIRE(v1[1] == 5);
+    v1.erase(1);
+    REQUIRE(v1[1] == 1);
+
+    v1.erase(1, 4);
+    REQUIRE(v1.size() == 3);
+    REQUIRE(v1[0] == 0);
+    REQUIRE(v1[1] == 4);
+    REQUIRE(v1[2] == 5);
+    REQUIRE_THROWS(v1.erase(3));
+    REQUIRE_THROWS(v1.erase(2, 4));
+
+    v1.eraseUnordered(0);
+    REQUIRE(v1.size() == 2);
+    REQUIRE(v1[0] == 5);
+    REQUIRE(v1[1] == 4);
+    v1.eraseUnordered(1);
+    REQUIRE(v1.size() == 1);
+}
+
+
+
+TEST_CASE("Vector insert, emplace and erase at positions, string")
+{
+    Vector<std::string> v1{"a", "c"};
+    v1.insert(1, std::string("b"));
+    v1.emplace(0, 2, 'z');
+    REQUIRE(v1.size() == 4);
+    REQUIRE(v1[0] == "zz");
+    REQUIRE(v1[2] == "b");
+    REQUIRE(v1[3] == "c");
+
+    v1.erase(0, 2);
+    REQUIRE(v1.size() == 2);
+    REQUIRE(v1[0] == "b");
+
+    v1.pushBack("d");
+    v1.eraseUnordered(0);
+    REQUIRE(v1.size() == 2);
+    REQUIRE(v1[0] == "d");
+    REQUIRE(v1[1] == "c");
+
+    Vector<std::unique_ptr<int>> v2;
+    v2.emplaceBack(new int(1));
+    v2.emplace(0, new int(0));
+    v2.erase(1);
+    REQUIRE(v2.size() == 1);
+    REQUIRE(*v2[0] == 0);
+}
+
+
+
+TEST_CASE("Vector SIMD reductions match scalar kernels, int32_t and int64_t")
+{
+    for (std::size_t n : {0, 1, 3, 15, 16, 17, 63, 64, 65, 257, 1000}) {
+        Vector<std::int32_t> v32;
+        Vector<std::int64_t> v64;
+        for (std::size_t i = 0; i < n; ++i) {
+            v32.pushBack(static_cast<std::int32_t>((i * 7919) % 101) - 50);
+            v64.pushBack(static_cast<std::int64_t>((i * 7919) % 101) - 50);
+        }
+
+        REQUIRE(kernels::sum(v32) == std::accumulate(v32.begin(), v32.end(), 0));
+        REQUIRE(kernels::sum(v64) == std::accumulate(v64.begin(), v64.end(), std::int64_t(0)));
+        REQUIRE(kernels::dot(v64, v64) == std::inner_product(v64.begin(), v64.end(), v64.begin(), std::int64_t(0)));
+        REQUIRE(kernels::argmin(v32) == static_cast<std::size_t>(std::min_element(v32.begin(), v32.end()) - v32.begin()));
+        REQUIRE(kernels::argmax(v64) == static_cast<std::size_t>(std::max_element(v64.begin(), v64.end()) - v64.begin()));
+        REQUIRE(kernels::count(v32, 7) == static_cast<std::size_t>(std::count(v32.begin(), v32.end(), 7)));
+        REQUIRE(kernels::find(v64, 7) == static_cast<std::size_t>(std::find(v64.begin(), v64.end(), 7) - v64.begin()));
+
+        Vector<std::int32_t> expected(v32);
+        std::partial_sum(expected.begin(), expected.end(), expected.begin());
+        kernels::prefixSum(v32);
+        REQUIRE(std::equal(v32.begin(), v32.end(), expected.begin()));
+    }
+
+    Vector<std::int32_t> v1{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 9};
+    REQUIRE(kernels::min(v1) == 1);
+    REQUIRE(kernels::argmin(v1) == 1);
+    REQUIRE(kernels::max(v1) == 9);
+    REQUIRE(kernels::argmax(v1) == 5);
+    REQUIRE(kernels::find(v1, 42) == v1.size());
+
+    Vector<std::int32_t> empty;
+    REQUIRE(kernels::argmin(empty) == 0);
+    REQUIRE_THROWS_AS(kernels::min(empty), const char*);
+    REQUIRE_THROWS_AS(kernels::dot(v1, empty), const char*);
+}
+
+
+
+TEST_CASE("Vector SIMD reductions match scalar kernels, float and double")
+{
+    Vector<float> v1;
+    Vector<double> v2;
+    for (std::size_t i = 0; i < 1001; ++i) {
+        v1.pushBack(std::sin(static_cast<float>(i)) * 100.0f);
+        v2.pushBack(std::cos(static_cast<double>(i)) * 100.0);
+    }
+
+    // Разбиение на частичные суммы одинаково на всех путях: результат совпадает побитово
+    REQUIRE(kernels::sum(v1) == kernels::detail::ScalarKernels<float>::sum(v1.data(), v1.size()));
+    REQUIRE(kernels::sum(v2) == kernels::detail::ScalarKernels<double>::sum(v2.data(), v2.size()));
+    REQUIRE(std::fabs(kernels::sum(v2) - std::accumulate(v2.begin(), v2.end(), 0.0)) < 1e-9);
+    REQUIRE(std::fabs(kernels::dot(v2, v2) - std::inner_product(v2.begin(), v2.end(), v2.begin(), 0.0)) < 1e-6);
+
+    REQUIRE(kernels::argmin(v1) == static_cast<std::size_t>(std::min_element(v1.begin(), v1.end()) - v1.begin()));
+    REQUIRE(kernels::argmax(v2) == static_cast<std::size_t>(std::max_element(v2.begin(), v2.end()) - v2.begin()));
+    REQUIRE(kernels::max(v2) == *std::max_element(v2.begin(), v2.end()));
+    REQUIRE(kernels::find(v1, v1[777]) == 777);
+    REQUIRE(kernels::count(v2, v2[5]) == 1);
+
+    Vector<double> expected(v2);
+    std::partial_sum(expected.begin(), expected.end(), expected.begin());
+    kernels::prefixSum(v2);
+    for (std::size_t i = 0; i < v2.size(); ++i) {
+        REQUIRE(std::fabs(v2[i] - expected[i]) < 1e-9);
+    }
+}
+
+
+
+// Целые совпадают точно; у float и double порядок сложений в dot и prefixSum зависит от пути
+template<typename Type>
+bool sameResult(Type a, Type b)
+{
+    if constexpr (std::is_integral<Type>::value) {
+        return a == b;
+    } else {
+        return std::fabs(a - b) <= 1e-4 * std::max<Type>(1, std::fabs(b));
+    }
+}
+
+
+
+template<typename Type>
+void requireSameOnEveryIsa(const Vector<Type>& v)
+{
+    const kernels::Isa saved = kernels::activeIsa();
+
+    kernels::setIsa(kernels::Isa::Scalar);
+    const Type sum = kernels::sum(v);
+    const Type dot = kernels::dot(v, v);
+    const std::size_t argmin = kernels::argmin(v);
+    const std::size_t argmax = kernels::argmax(v);
+    const std::size_t count = kernels::count(v, v[v.size() / 2]);
+    const std::size_t find = kernels::find(v, v[v.size() - 1]);
+    Vector<Type> prefix(v);
+    kernels::prefixSum(prefix);
+
+    for (kernels::Isa isa : {kernels::Isa::Sse42, kernels::Isa::Avx2, kernels::Isa::Avx512}) {
+        if (kernels::setIsa(isa) != isa) {
+            continue;
+        }
+        REQUIRE(kernels::sum(v) == sum);
+        REQUIRE(sameResult(kernels::dot(v, v), dot));
+        REQUIRE(kernels::argmin(v) == argmin);
+        REQUIRE(kernels::argmax(v) == argmax);
+        REQUIRE(kernels::count(v, v[v.size() / 2]) == count);
+        REQUIRE(kernels::find(v, v[v.size() - 1]) == find);
+
+        Vector<Type> other(v);
+        kernels::prefixSum(other);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            REQUIRE(sameResult(other[i], prefix[i]));
+        }
+
+        Vector<Type> filled;
+        filled.assign(v.size(), v[1]);
+        REQUIRE(std::count(filled.begin(), filled.end(), v[1]) == static_cast<std::ptrdiff_t>(v.size()));
+        kernels::copy(v.data(), v.size(), filled.data());
+        REQUIRE(std::equal(v.begin(), v.end(), filled.begin()));
+    }
+
+    kernels::setIsa(saved);
+}
+
+
+
+TEST_CASE("Vector kernels give identical results on every instruction set")
+{
+    REQUIRE(kernels::setIsa(kernels::Isa::Avx512) == kernels::detectedIsa());
+    REQUIRE(kernels::setIsa(kernels::Isa::Scalar) == kernels::Isa::Scalar);
+    REQUIRE(kernels::activeIsa() == kernels::Isa::Scalar);
+
+    kernels::Isa isa;
+    REQUIRE(kernels::parseIsa("avx2", isa));
+    REQUIRE(isa == kernels::Isa::Avx2);
+    REQUIRE(std::string(kernels::isaName(kernels::Isa::Sse42)) == "sse4.2");
+    REQUIRE_FALSE(kernels::parseIsa("avx3", isa));
+
+    for (std::size_t n : {2, 31, 64, 1000, 4099}) {
+        Vector<float> v1;
+        Vector<double> v2;
+        Vector<std::int32_t> v3;
+        Vector<std::int64_t> v4;
+        for (std::size_t i = 0; i < n; ++i) {
+            v1.pushBack(std::sin(static_cast<float>(i)) * 10.0f);
+            v2.pushBack(std::cos(static_cast<double>(i)) * 10.0);
+            v3.pushBack(static_cast<std::int32_t>((i * 2654435761u) % 1000) - 500);
+            v4.pushBack(static_cast<std::int64_t>((i * 2654435761u) % 1000) * 1000000007);
+        }
+        requireSameOnEveryIsa(v1);
+        requireSameOnEveryIsa(v2);
+        requireSameOnEveryIsa(v3);
+        requireSameOnEveryIsa(v4);
+    }
+}
+
+
+
+TEST_CASE("Vector element-wise expressions, double")
+{
+    Vector<double> a{1, 2, 3, 4};
+    Vector<double> b{5, 6, 7, 8};
+    Vector<double> c{0.5, 0.5, 0.5, 0.5};
+    Vector<double> d{2, 4, 6, 8};
+
+    Vector<double> v1 = a * b + c * d;
+    REQUIRE(v1.size() == 4);
+    REQUIRE(v1.capacity() == 4);
+    REQUIRE(v1[0] == 6.0);
+    REQUIRE(v1[3] == 36.0);
+
+    auto expression = (a - b) / 2.0 + 1;
+    Vector<double> v2(expression);
+    REQUIRE(v2[0] == -1.0);
+    REQUIRE(v2[3] == -1.0);
+
+    v2 = -a * 3.0 - d;
+    REQUIRE(v2.size() == 4);
+    REQUIRE(v2[1] == -10.0);
+
+    // Вектор может входить в присваиваемое ему выражение
+    a = a * a + 1.0;
+    REQUIRE(a[0] == 2.0);
+    REQUIRE(a[3] == 17.0);
+
+    Vector<double> big;
+    for (int i = 0; i < 1000; ++i) {
+        big.pushBack(i);
+    }
+    Vector<double> v3;
+    v3.pushBack(42);
+    v3 = big * big - big;
+    REQUIRE(v3.size() == 1000);
+    REQUIRE(v3[999] == 999.0 * 999.0 - 999.0);
+
+    Vector<double> shorter{1, 2};
+    REQUIRE_THROWS_AS(a + shorter, const char*);
+}
+
+
+
+TEST_CASE("Vector element-wise expressions, int and float")
+{
+    Vector<int> a{1, 2, 3};
+    Vector<int> b{4, 5, 6};
+    Vector<int> v1 = a * b - 2 * a + b / 2;
+    REQUIRE(v1[0] == 4);
+    REQUIRE(v1[1] == 8);
+    REQUIRE(v1[2] == 15);
+
+    // Выражение из double приводится к элементам float при записи
+    Vector<float> v2 = a * 0.5;
+    REQUIRE(v2[0] == 0.5f);
+    REQUIRE(v2[2] == 1.5f);
+
+    Vector<int> empty;
+    Vector<int> v3 = empty + empty;
+    REQUIRE(v3.empty());
+}
+
+
+
+TEST_CASE("Vector parallel copy, assign, resize and append")
+{
+    REQUIRE(parallel::threadsFor(std::size_t(1) << 30) == 1);
+
+    parallel::enable(64 * 1024, 4);
+    REQUIRE(parallel::threadsFor(32 * 1024) == 1);
+    REQUIRE(parallel::threadsFor(1024 * 1024) == 4);
+
+    // Проверки Catch не потокобезопасны: части только учитываются, проверки - после join
+    std::atomic<std::size_t> calls{0};
+    std::atomic<std::size_t> covered{0};
+    std::atomic<std::size_t> misaligned{0};
+    parallel::forEachChunk(100001, sizeof(std::uint64_t), [&](std::size_t first, std::size_t last) {
+        calls.fetch_add(1);
+        covered.fetch_add(last - first);
+        if (first % 512 != 0) {
+            misaligned.fetch_add(1);
+        }
+    });
+    REQUIRE(calls.load() == 4);
+    REQUIRE(covered.load() == 100001);
+    REQUIRE(misaligned.load() == 0);
+
+    Vector<std::uint64_t> v1;
+    v1.assign(100001, 0x0102030405060708);
+    REQUIRE(std::count(v1.begin(), v1.end(), 0x0102030405060708u) == 100001);
+
+    v1.resize(300001);
+    REQUIRE(v1[100000] == 0x0102030405060708u);
+    REQUIRE(std::count(v1.begin(), v1.end(), 0u) == 200000);
+
+    std::iota(v1.begin(), v1.end(), 0);
+    Vector<std::uint64_t> v2(v1);
+    REQUIRE(v2.size() == v1.size());
+    REQUIRE(std::equal(v1.begin(), v1.end(), v2.begin()));
+
+    v2.append(v1.data(), v1.size());
+    REQUIRE(v2.size() == 600002);
+    REQUIRE(v2[300001] == 0);
+    REQUIRE(v2[600001] == 300000);
+
+    parallel::disable();
+    REQUIRE(parallel::threadsFor(std::size_t(1) << 30) == 1);
+}
+
+
+
+TEST_CASE("Vector with NumaAllocator, bind, interleave and migrate")
+{
+    const int nodes = numa::nodeCount();
+    REQUIRE(nodes >= 1);
+
+    using Allocator = NumaAllocator<std::uint64_t, 64 * 1024>;
+
+    Vector<std::uint64_t, Allocator> v1{Allocator(NumaPolicy::bind(0))};
+    for (std::uint64_t i = 0; i < 100000; ++i) {
+        v1.pushBack(i);
+    }
+    REQUIRE(v1[99999] == 99999);
+    // -1 - ядро не сообщает узел (нет NUMA или get_mempolicy запрещён)
+    int node = numa::nodeOf(v1.data());
+    REQUIRE((node == 0 || node == -1));
+
+    Vector<std::uint64_t, Allocator> v2{Allocator(NumaPolicy::interleave())};
+    v2.assign(100000, 7);
+    REQUIRE(v2[50000] == 7);
+
+    // Политики различаются: перемещение переносит элементы в память v2
+    v2 = std::move(v1);
+    REQUIRE(v2.size() == 100000);
+    REQUIRE(v2[12345] == 12345);
+    REQUIRE(v2.getAllocator().policy() == NumaPolicy::interleave());
+
+    // На несуществующий узел перенести нельзя, на узел 0 - если ядро разрешает move_pages
+    REQUIRE_FALSE(v2.migrate(nodes));
+    REQUIRE_FALSE(v2.migrate(-1));
+    v2.migrate(0);
+    REQUIRE(v2[99999] == 99999);
+
+    REQUIRE_FALSE(numa::bind(v2.data(), 4096, NumaPolicy::bind(nodes)));
+    Vector<int, NumaAllocator<int>> small(NumaAllocator<int>(NumaPolicy::preferred(0)));
+    small.pushBack(1);
+    REQUIRE(small.back() == 1);
+}
+
+
+
+struct Match
+{
+    std::uint32_t first;
+    std::uint32_t second;
+};
+
+TEST_CASE("ClaimWriter parallel writes into a pre-sized Vector")
+{
+    Vector<Match> v1;
+    v1.pushBack({7, 7});
+
+    const unsigned threads = 4;
+    const std::uint32_t batches = 1000;
+    ClaimWriter<decltype(v1)> writer(v1, threads * batches * 3);
+    REQUIRE(v1.size() == 1);
+    REQUIRE(v1.capacity() >= 1 + threads * batches * 3);
+
+    // Потоки занимают отрезки разной длины: 1, 2 или 3 элемента
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (std::uint32_t batch = 0; batch < batches; ++batch) {
+                auto span = writer.claim(1 + batch % 3);
+                for (std::size_t i = 0; i < span.size; ++i) {
+                    span[i] = Match{t, batch};
+                }
+                writer.publish(span.size);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::size_t expected = 1 + threads * (batches / 3 * 6 + 1);
+    REQUIRE(writer.claimed() == expected - 1);
+    REQUIRE(writer.finalize() == expected);
+    REQUIRE(v1.size() == expected);
+    REQUIRE(v1[0].first == 7);
+
+    std::vector<std::size_t> perThread(threads);
+    for (std::size_t i = 1; i < v1.size(); ++i) {
+        ++perThread[v1[i].first];
+    }
+    for (auto count : perThread) {
+        REQUIRE(count == (expected - 1) / threads);
+    }
+
+    Vector<int> v2;
+    ClaimWriter<Vector<int>> small(v2, 4);
+    small.claim(3);
+    REQUIRE_THROWS_AS(small.finalize(), const char*);
+    REQUIRE_THROWS_AS(small.claim(2), const char*);
+    small.publish(3);
+    REQUIRE_THROWS_AS(small.finalize(), const char*);
+    REQUIRE(v2.size() == 0);
+    REQUIRE_THROWS_AS(v2.commitOverwritten(5), const char*);
+}
+
+
+
+TEST_CASE("ThreadLocalVector appends per thread and combines shards")
+{
+    ThreadLocalVector<std::uint64_t> v1;
+    REQUIRE(v1.shardCount() == 0);
+    REQUIRE(v1.combine().empty());
+
+    // Части разного размера; склейка идёт в несколько потоков по частям результата
+    parallel::enable(16 * 1024, 4);
+    const unsigned threads = 4;
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&v1, t] {
+            auto& local = v1.local();
+            for (std::uint64_t i = 0; i < 5000 * (t + 1); ++i) {
+                local.pushBack(t * 1000000 + i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    REQUIRE(v1.shardCount() == threads);
+    REQUIRE(v1.size() == 50000);
+
+    Vector<std::uint64_t> combined = v1.combine();
+    parallel::disable();
+    REQUIRE(combined.size() == 50000);
+    std::size_t position = 0;
+    for (std::size_t s = 0; s < v1.shardCount(); ++s) {
+        const auto& shard = v1.shard(s);
+        REQUIRE(std::equal(shard.begin(), shard.end(), combined.begin() + position));
+        position += shard.size();
+    }
+
+    v1.local().pushBack(1);
+    v1.local().pushBack(2);
+    REQUIRE(v1.shardCount() == threads + 1);
+    v1.clear();
+    REQUIRE(v1.size() == 0);
+    REQUIRE(v1.shardCount() == threads + 1);
+
+    ThreadLocalVector<std::string> v2;
+    v2.local().pushBack("a");
+    std::thread([&v2] { v2.local().pushBack("b"); }).join();
+    Vector<std::string> strings = v2.combine();
+    REQUIRE(strings.size() == 2);
+    REQUIRE(strings[0] == "a");
+    REQUIRE(strings[1] == "b");
+}